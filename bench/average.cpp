@@ -0,0 +1,105 @@
+// Precision of the averaged perceptron over long streams
+//
+// g++ -O2 -Ilib bench/average.cpp lib/oll.cpp -o average -pthread
+// ./average [exampleN [featureN]]
+//
+// AP is trained on a noisy stream (default 20M examples of 10 out of 1000
+// features), so that mistakes and updates go on to the end. Every tenfold
+// of examples, the averaged weights w0 - wa / (exampleN+1) of oll are
+// compared with those of a double precision accumulator replaying the same
+// updates, and with those of a plain float accumulator, which is what wa
+// was before it carried its rounding in double. The training time of AP is
+// then given against that of P, whose update has no accumulator.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <chrono>
+#include <vector>
+#include "oll.hpp"
+
+using namespace oll_tool;
+
+static double now(){
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// max |avg - reference| over max |reference|
+static double relError(const std::vector<double>& avg, const std::vector<double>& reference){
+  double diff = 0.0, norm = 0.0;
+  for (size_t i = 0; i < reference.size(); i++){
+    diff = std::max(diff, fabs(avg[i] - reference[i]));
+    norm = std::max(norm, fabs(reference[i]));
+  }
+  return norm > 0.0 ? diff / norm : 0.0;
+}
+
+int main(int argc, char** argv){
+  const size_t exampleN = argc >= 2 ? strtoul(argv[1], NULL, 10) : 20000000;
+  const int featureN    = argc >= 3 ? atoi(argv[2]) : 1000;
+
+  oll ol;
+  fvec w0(featureN), waFloat(featureN); // float replay of oll's updates
+  std::vector<double> waDouble(featureN);
+  std::vector<float> truth(featureN);
+  srand(0);
+  for (int i = 0; i < featureN; i++) truth[i] = (rand() % 2001 - 1000) / 1000.f;
+
+  printf("%12s %14s %14s\n", "examples", "oll error", "float error");
+  size_t next = 1000;
+  fv_t fv(10);
+  for (size_t n = 0; n < exampleN; n++){
+    float dot = 0.f;
+    for (size_t j = 0; j < fv.size(); j++){
+      fv[j] = std::make_pair(rand() % featureN, (rand() % 1000) / 1000.f);
+      dot += truth[fv[j].first] * fv[j].second;
+    }
+    const int y = (dot > 0.f) != (rand() % 10 == 0) ? 1 : -1; // 10% noise
+
+    float margin = 0.f;
+    for (size_t j = 0; j < fv.size(); j++) margin += w0[fv[j].first] * fv[j].second;
+    ol.trainExample(AP_s(), fv, y);
+    if (margin * y <= 0.f){
+      for (size_t j = 0; j < fv.size(); j++){
+	w0[fv[j].first] += fv[j].second * (float)y;
+	waFloat[fv[j].first] += fv[j].second * (y * (n+1.f));
+	waDouble[fv[j].first] += fv[j].second * (y * (n+1.0));
+      }
+    }
+
+    if (n + 1 != next && n + 1 != exampleN) continue;
+    next *= 10;
+    size_t k = 0;
+    const float* wa = ol.getParam("wa", k);
+    std::vector<double> reference(featureN), avgOll(featureN), avgFloat(featureN);
+    for (int i = 0; i < featureN; i++){
+      reference[i] = w0[i] - waDouble[i] / (n+2.0);
+      avgOll[i]    = w0[i] - ((size_t)i < k ? wa[i] : 0.f) / (n+2.f);
+      avgFloat[i]  = w0[i] - waFloat[i] / (n+2.f);
+    }
+    printf("%12zu %14.3g %14.3g\n", n + 1, relError(avgOll, reference), relError(avgFloat, reference));
+  }
+
+  std::vector<fv_t> examples(100000, fv_t(10));
+  std::vector<int> labels(examples.size());
+  for (size_t n = 0; n < examples.size(); n++){
+    for (size_t j = 0; j < examples[n].size(); j++){
+      examples[n][j] = std::make_pair(rand() % featureN, (rand() % 1000) / 1000.f);
+    }
+    labels[n] = rand() % 2 ? 1 : -1;
+  }
+  const int passN = 10;
+  const char* names[] = {"P", "AP"};
+  for (int a = 0; a < 2; a++){
+    oll o;
+    const double start = now();
+    for (int pass = 0; pass < passN; pass++){
+      for (size_t n = 0; n < examples.size(); n++){
+	if (a == 0) o.trainExample(P_s(), examples[n], labels[n]);
+	else o.trainExample(AP_s(), examples[n], labels[n]);
+      }
+    }
+    printf("%-2s %.0f examples/s\n", names[a], passN * examples.size() / (now() - start));
+  }
+  return 0;
+}
@@ -0,0 +1,62 @@
+// Time of oll::save and oll::load for a large model
+//
+// g++ -O2 -Ilib bench/load.cpp lib/oll.cpp -o load -pthread
+// ./load [featureN [file]]
+//
+// A CW model (w and cov of featureN floats each) is trained on a few
+// examples reaching the last feature, saved to file (default
+// /tmp/oll_load.model) and loaded back several times. Such a model is
+// mostly untouched entries, which save writes sparse: load time is then
+// that of filling the dense vectors.
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include "oll.hpp"
+
+using namespace oll_tool;
+
+static double now(){
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv){
+  const size_t featureN = argc >= 2 ? strtoul(argv[1], NULL, 10) : 50000000;
+  const std::string filename = argc >= 3 ? argv[2] : "/tmp/oll_load.model";
+
+  oll ol;
+  srand(0);
+  for (int i = 0; i < 100; i++){
+    fv_t fv;
+    for (int j = 0; j < 30; j++){
+      fv.push_back(std::make_pair(rand() % (int)featureN, (rand() % 1000) / 1000.f));
+    }
+    fv.push_back(std::make_pair((int)featureN - 1, 1.f));
+    ol.trainExample(CW_s(), fv, i % 2 ? 1 : -1);
+  }
+
+  double start = now();
+  if (ol.save(filename.c_str()) == -1){
+    fprintf(stderr, "%s\n", ol.getErrorLog().c_str());
+    return 1;
+  }
+  const double saveSec = now() - start;
+  const double mb = ol.saveSize() / 1e6;
+  printf("save %.1fMB  %.3fs  %.0fMB/s\n", mb, saveSec, mb / saveSec);
+
+  const int runN = 5;
+  double best = 1e30;
+  for (int i = 0; i < runN; i++){
+    oll loaded;
+    start = now();
+    if (loaded.load(filename.c_str()) == -1){
+      fprintf(stderr, "%s\n", loaded.getErrorLog().c_str());
+      return 1;
+    }
+    best = std::min(best, now() - start);
+  }
+  printf("load %.1fMB  %.3fs  %.0fMB/s (best of %d)\n", mb, best, mb / best, runN);
+  remove(filename.c_str());
+  return 0;
+}
@@ -0,0 +1,88 @@
+// Scaling and accuracy of parallel training (oll::trainFile with threadN > 1)
+//
+// g++ -O2 -Ilib bench/parallel.cpp lib/oll.cpp -o parallel -pthread
+// ./parallel [train test]
+//
+// Without arguments, sparse examples labeled by a random hyperplane (with 5% noise)
+// are written to /tmp/oll_parallel.{train,test}.
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <string>
+#include "oll.hpp"
+
+using namespace oll_tool;
+
+static void generate(const char* filename, const std::vector<float>& h, const int exampleN, const int seed){
+  FILE* fp = fopen(filename, "w");
+  srand(seed);
+  for (int i = 0; i < exampleN; i++){
+    fv_t fv;
+    float score = 0.f;
+    for (int j = 0; j < 30; j++){
+      const int id = rand() % h.size();
+      const float val = (rand() % 1000) / 1000.f;
+      fv.push_back(std::make_pair(id, val));
+      score += h[id] * val;
+    }
+    int y = score >= 0 ? 1 : -1;
+    if (rand() % 100 < 5) y = -y;
+    fprintf(fp, "%+d", y);
+    std::sort(fv.begin(), fv.end());
+    for (size_t j = 0; j < fv.size(); j++){
+      fprintf(fp, " %d:%f", fv[j].first, fv[j].second);
+    }
+    fprintf(fp, "\n");
+  }
+  fclose(fp);
+}
+
+template<class T>
+static void bench(const T& a, const char* name, const char* train, const char* test, const parallelMethod pm){
+  const int threads[] = {1, 2, 4, 8};
+  for (size_t i = 0; i < sizeof(threads) / sizeof(threads[0]); i++){
+    oll ol;
+    srand(0);
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (ol.trainFile(a, train, 10, false, true, threads[i], pm) == -1){
+      fprintf(stderr, "%s\n", ol.getErrorLog().c_str());
+      return;
+    }
+    const double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::vector<int> confMat;
+    ol.testFile(test, confMat);
+    const int correctNum = confMat[0] + confMat[3];
+    const int num        = confMat[0] + confMat[1] + confMat[2] + confMat[3];
+    printf("%-4s %-7s threads:%d  %.3fs  accuracy %.3f%%\n", name, pm == MIX ? "MIX" : "HOGWILD",
+	   threads[i], sec, correctNum * 100.f / num);
+  }
+}
+
+int main(int argc, char** argv){
+  std::string train = "/tmp/oll_parallel.train";
+  std::string test  = "/tmp/oll_parallel.test";
+  if (argc >= 3){
+    train = argv[1];
+    test  = argv[2];
+  } else {
+    std::vector<float> h(100000);
+    srand(1);
+    for (size_t i = 0; i < h.size(); i++){
+      h[i] = (rand() % 2000) / 1000.f - 1.f;
+    }
+    generate(train.c_str(), h, 100000, 2);
+    generate(test.c_str(),  h, 20000,  3);
+  }
+
+  const parallelMethod pms[] = {HOGWILD, MIX};
+  for (size_t i = 0; i < 2; i++){
+    bench(P_s(),   "P",   train.c_str(), test.c_str(), pms[i]);
+    bench(PA_s(),  "PA",  train.c_str(), test.c_str(), pms[i]);
+    bench(PA1_s(), "PA1", train.c_str(), test.c_str(), pms[i]);
+    bench(PA2_s(), "PA2", train.c_str(), test.c_str(), pms[i]);
+    bench(CW_s(),  "CW",  train.c_str(), test.c_str(), pms[i]);
+  }
+  bench(AP_s(),  "AP",  train.c_str(), test.c_str(), MIX);
+  return 0;
+}
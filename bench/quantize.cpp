@@ -0,0 +1,98 @@
+// Accuracy, size and scoring time of the exports of a model
+//
+// g++ -O2 -Ilib bench/quantize.cpp lib/oll.cpp -o quantize -pthread
+// ./quantize model test
+//
+// model is a file written by oll::save (or the original oll) and test a
+// libsvm file. The model is exported with each precision to
+// /tmp/oll_quantize.model, mapped with mappedModel and scored on test;
+// accuracy is given against the labels and against the float model,
+// whose scores are those of oll::classify.
+
+#include <cstdio>
+#include <cmath>
+#include <chrono>
+#include <string>
+#include "oll.hpp"
+
+using namespace oll_tool;
+
+static double now(){
+  return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static long fileSize(const char* filename){
+  FILE* fp = fopen(filename, "rb");
+  if (fp == NULL) return -1;
+  fseek(fp, 0, SEEK_END);
+  const long size = ftell(fp);
+  fclose(fp);
+  return size;
+}
+
+int main(int argc, char** argv){
+  if (argc < 3){
+    fprintf(stderr, "usage: %s model test\n", argv[0]);
+    return 1;
+  }
+  const char* exported = "/tmp/oll_quantize.model";
+
+  oll ol;
+  if (ol.load(argv[1], INFERENCE) == -1){
+    fprintf(stderr, "%s\n", ol.getErrorLog().c_str());
+    return 1;
+  }
+  dataset test;
+  if (test.readFile(argv[2]) == -1){
+    fprintf(stderr, "%s\n", test.getErrorLog().c_str());
+    return 1;
+  }
+  const size_t n = test.size();
+  if (n == 0) return 0;
+
+  std::vector<float> reference(n);
+  int correct = 0;
+  fv_t fv;
+  for (size_t i = 0; i < n; i++){
+    test.get(i, fv);
+    reference[i] = ol.classify(fv);
+    correct += (reference[i] >= 0 ? 1 : -1) == test.label(i);
+  }
+  printf("float model  accuracy %.3f%%\n", correct * 100.f / n);
+
+  const precision ps[] = {FLOAT32, FLOAT16, BFLOAT16, INT8};
+  const char* names[]  = {"FLOAT32", "FLOAT16", "BFLOAT16", "INT8"};
+  for (size_t k = 0; k < sizeof(ps) / sizeof(ps[0]); k++){
+    if (ol.exportModel(exported, ps[k]) == -1){
+      fprintf(stderr, "%s\n", ol.getErrorLog().c_str());
+      return 1;
+    }
+    mappedModel m;
+    if (m.open(exported) == -1){
+      fprintf(stderr, "%s\n", m.getErrorLog().c_str());
+      return 1;
+    }
+    std::vector<float> scores(n);
+    const double start = now();
+    for (size_t i = 0; i < n; i++){
+      test.get(i, fv);
+      scores[i] = m.classify(fv);
+    }
+    const double sec = now() - start;
+
+    int correctK = 0;
+    int agree = 0;
+    double maxDiff = 0.0;
+    for (size_t i = 0; i < n; i++){
+      const int label = scores[i] >= 0 ? 1 : -1;
+      correctK += label == test.label(i);
+      agree += label == (reference[i] >= 0 ? 1 : -1);
+      maxDiff = std::max(maxDiff, (double)fabs(scores[i] - reference[i]));
+    }
+    printf("%-8s %8ld bytes  accuracy %.3f%% (%+.3f)  agreement %.3f%%  max score diff %.3g  %.0f examples/s\n",
+	   names[k], fileSize(exported), correctK * 100.f / n, (correctK - correct) * 100.f / n,
+	   agree * 100.f / n, maxDiff, n / sec);
+  }
+  remove(exported);
+  return 0;
+}
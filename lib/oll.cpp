@@ -3,11 +3,30 @@
 #include <string>
 #include <iostream>
 #include <cmath> // sqrt
+#include <climits> // INT_MAX
+#include <thread>
+#include <atomic>
+#include <chrono>
+#ifdef __F16C__
+#include <immintrin.h> // _cvtsh_ss
+#endif
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 #include "oll.hpp"
 
 namespace oll_tool{  
+  namespace {
+    const size_t SV_TILE     = 16384; // support vectors per margin tile
+    const size_t BLOCK_REUSE = 4;     // min. features per distinct id in a block to tile
+  }
+
   int trainFile(const char* trainfile, const char* modelfile, const trainMethod tm, 
-		const float C, const float bias, const int iter, bool verb, bool shuffle){
+		const float C, const float bias, const int iter, bool verb, bool shuffle,
+		const int threadN, const parallelMethod pm){
     oll ol;
     ol.setC(C);
     ol.setBias(bias);
@@ -15,28 +34,28 @@ namespace oll_tool{
     bool error = false;
     if (tm == P){
       P_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else if (tm == AP){
       AP_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else if (tm == PA){
       PA_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else if (tm == PA1){
       PA1_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else if (tm == PA2){
       PA2_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else if (tm == PAK){
       PAK_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else if (tm == CW){
       CW_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else if (tm == AL){
       AL_s a;
-      if (ol.trainFile(a, trainfile, iter, verb, shuffle) == -1) error = true;
+      if (ol.trainFile(a, trainfile, iter, verb, shuffle, threadN, pm) == -1) error = true;
     } else {
       if (verb){
 	std::cerr << "unknown trainMethod" << std::endl;
@@ -94,31 +113,117 @@ namespace oll_tool{
     return 0;
   }
 
+  namespace {
+    int parseExample(const std::string& line, fv_t& fv, int& y, std::ostringstream& errorLog){
+      std::istringstream is(line);
+      if (!(is >> y)){
+	errorLog << "parse error: no label ";
+	return -1;
+      }
+    
+      if (y != 1 &&
+	  y != -1){
+	errorLog << "parse error: y is not +1 nor -1 ";
+      }
+    
+      int  id = 0;
+      char sep = 0;
+      float val = 0.f;
+      while (is >> id >> sep >> val){
+	fv.push_back(std::make_pair(id, val));
+      }
+      return 0;
+    }
+  }
+
   int oll::parseLine(const std::string& line, fv_t& fv, int& y){
-    std::istringstream is(line);
-    if (!(is >> y)){
-      errorLog << "parse error: no label ";
-      return -1;
+    return parseExample(line, fv, y, errorLog);
+  }
+
+
+  trainJob::~trainJob(){
+    ctl.cancel = true;
+    worker.join();
+  }
+
+  bool trainJob::wait(const double timeout){
+    std::unique_lock<std::mutex> lock(m);
+    if (timeout < 0){
+      cv.wait(lock, [this](){ return finished; });
+      return true;
     }
-    
-    if (y != 1 &&
-	y != -1){
-      errorLog << "parse error: y is not +1 nor -1 ";
+    return cv.wait_for(lock, std::chrono::duration<double>(timeout), [this](){ return finished; });
+  }
+
+  int trainJob::result(){
+    std::lock_guard<std::mutex> lock(m);
+    return ret;
+  }
+
+  dataset::dataset() : indptr(1, 0) {}
+
+  int dataset::readFile(const char* filename){
+    std::ifstream ifs(filename);
+    if (!ifs){
+      errorLog << "cannot open " << filename;
+      return -1;
     }
-    
-    int  id = 0;
-    char sep = 0;
-    float val = 0.f;
-    while (is >> id >> sep >> val){
-      fv.push_back(std::make_pair(id, val));
+
+    size_t lineN = 0;
+    std::string line;
+    fv_t fv;
+    while (getline(ifs, line)){
+      lineN++;
+      if (line[0] == '#') continue; // comment
+
+      fv.clear();
+      int y = 0;
+      if (parseExample(line, fv, y, errorLog) == -1){
+	errorLog << "line:" << lineN;
+	return -1;
+      }
+      for (size_t j = 0; j < fv.size(); j++){
+	indices.push_back(fv[j].first);
+	data.push_back(fv[j].second);
+      }
+      indptr.push_back(indices.size());
+      ys.push_back(y);
     }
     return 0;
   }
 
+  size_t dataset::size() const {
+    return ys.size();
+  }
+
+  void dataset::get(const size_t i, fv_t& fv) const {
+    fv.clear();
+    for (size_t k = indptr[i]; k < indptr[i+1]; k++){
+      fv.push_back(std::make_pair(indices[k], data[k]));
+    }
+  }
+
+  int dataset::label(const size_t i) const {
+    return ys[i];
+  }
+
+  std::string dataset::getErrorLog() const {
+    return errorLog.str();
+  }
+
+  void dataset::rows::labels(std::vector<int>& ys_) const {
+    ys_.resize(n);
+    for (size_t i = 0; i < n; i++){
+      ys_[i] = label(i);
+    }
+  }
 
-  oll::oll() : exampleN(0), featureN(0), updateN(0), C(1.f), bias(0.f), b(0.f), b0(0.f), ba(0.f), covb(0.f) {}
+  oll::oll() : exampleN(0), featureN(0), updateN(0), C(1.f), bias(0.f), b(0.f), b0(0.f), ba(0.f), covb(0.f), trainable(true), editStamp(1), snapshotStamp(0),
+	       checkpointStamp(0), checkpointId(0), checkpointAlphaN(0), checkpointExampleN(0) {}
   oll::~oll() {}
 
+  thread_local size_t* oll::localUpdateN = NULL;
+
   void oll::setC(const float C_){
     C = C_;
   }
@@ -136,10 +241,13 @@ namespace oll_tool{
     return ret;
   }
 
-  float oll::getMarginK(const fv_t& fv) { // kernel
-    for (size_t i = 0; i < margins.size(); i++){
-      margins[i] = 0.f;
-    }
+  float oll::getMarginK(const fv_t& fv) const { // kernel
+    static thread_local fvec margins; // per-thread buffer
+    return getMarginK(fv, margins);
+  }
+
+  float oll::getMarginK(const fv_t& fv, fvec& margins) const {
+    margins.assign(alphas.size(), 0.f);
 
     for (size_t i = 0; i < fv.size(); i++){
       const int id = fv[i].first;
@@ -178,13 +286,102 @@ namespace oll_tool{
     return ret;
   }
 
+  void oll::reserve(const std::vector<std::pair<fv_t, int> >& examples, const bool withCov){
+    int maxId = -1;
+    for (size_t i = 0; i < examples.size(); i++){
+      for (size_t j = 0; j < examples[i].first.size(); j++){
+	maxId = std::max(maxId, examples[i].first[j].first);
+      }
+    }
+    const size_t n = maxId + 1;
+    if (w.size() < n) w.resize(n);
+    if (withCov && cov.size() < n) cov.resize(n, 1.f);
+    if (n > 0 && chunkStamps.size() <= (n-1) >> CHUNK_BITS) chunkStamps.resize(((n-1) >> CHUNK_BITS) + 1, 0);
+  }
+
+  void oll::copyParams(const oll& o){
+    exampleN = o.exampleN;
+    updateN  = o.updateN;
+    C    = o.C;
+    bias = o.bias;
+    w  = o.w;
+    b  = o.b;
+    w0 = o.w0;
+    b0 = o.b0;
+    wa = o.wa;
+    waRest = o.waRest;
+    ba = o.ba;
+    cov  = o.cov;
+    covb = o.covb;
+  }
+
+  // Averages w, w0, cov, the bias weights and wa (AP) of replicas trained
+  // from this model. wa is rescaled so that the averaged model classifies
+  // as the mean of the replicas' averaged perceptrons.
+  void oll::mixParams(const std::vector<std::shared_ptr<oll> >& replicas){
+    const float k = (float)replicas.size();
+    const size_t prevExampleN = exampleN;
+    size_t exampleSum = 0, updateSum = 0, wN = 0, w0N = 0, waN = 0, covN = 0;
+    for (size_t r = 0; r < replicas.size(); r++){
+      exampleSum += replicas[r]->exampleN - prevExampleN;
+      updateSum  += replicas[r]->updateN - updateN;
+      wN   = std::max(wN,   replicas[r]->w.size());
+      w0N  = std::max(w0N,  replicas[r]->w0.size());
+      waN  = std::max(waN,  replicas[r]->wa.size());
+      covN = std::max(covN, replicas[r]->cov.size());
+    }
+    exampleN = prevExampleN + exampleSum;
+    updateN += updateSum;
+
+    w.assign(wN, 0.f);
+    w0.assign(w0N, 0.f);
+    wa.assign(waN, 0.f);
+    waRest.clear();
+    cov.assign(covN, 0.f);
+    b = b0 = ba = covb = 0.f;
+    for (size_t r = 0; r < replicas.size(); r++){
+      const oll& o = *replicas[r];
+      const float scale = (exampleN + 1.f) / (o.exampleN + 1.f); // for wa
+      for (size_t i = 0; i < o.w.size(); i++)  w[i]  += o.w[i] / k;
+      for (size_t i = 0; i < o.w0.size(); i++) w0[i] += o.w0[i] / k;
+      for (size_t i = 0; i < o.wa.size(); i++) wa[i] += o.wa[i] * scale / k;
+      for (size_t i = 0; i < covN; i++) cov[i] += (i < o.cov.size() ? o.cov[i] : 1.f) / k;
+      b    += o.b / k;
+      b0   += o.b0 / k;
+      ba   += o.ba * scale / k;
+      covb += o.covb / k;
+    }
+
+    for (size_t i = 0; i < std::max(std::max(wN, w0N), covN); i += CHUNK_SIZE){
+      touch(i);
+    }
+  }
+
   void oll::update(fvec& v, const fv_t& fv, const float alpha) {
     for (size_t i = 0; i < fv.size(); i++){
       if (v.size() <= fv[i].first) v.resize(fv[i].first+1);
       v[fv[i].first] += fv[i].second * alpha;
+      touch(fv[i].first);
     }
     b += alpha * bias;
-    updateN++;
+    countUpdate();
+  }
+
+  // v += alpha * fv accumulated in double: rest keeps what v, rounded to
+  // float, leaves out. AP adds y * exampleN to wa, whose float sum would
+  // otherwise lose the updates of long streams to rounding.
+  void oll::update(fvec& v, fvec& rest, const fv_t& fv, const double alpha) {
+    for (size_t i = 0; i < fv.size(); i++){
+      const size_t id = fv[i].first;
+      if (v.size() <= id) v.resize(id+1);
+      if (rest.size() < v.size()) rest.resize(v.size());
+      const double sum = (double)v[id] + rest[id] + fv[i].second * alpha;
+      v[id] = (float)sum;
+      rest[id] = (float)(sum - v[id]);
+      touch(id);
+    }
+    b += (float)(alpha * bias);
+    countUpdate();
   }
 
 
@@ -204,7 +401,7 @@ namespace oll_tool{
     const float score = getMargin(w0, b0, fv) * y;
     if (score <= 0.f){
       update(w0, fv, y);
-      update(wa, fv, y * (exampleN+1.f));
+      update(wa, waRest, fv, y * (exampleN+1.0));
     }
     exampleN++;
   }
@@ -244,9 +441,9 @@ namespace oll_tool{
     for (size_t i = 0; i < fv.size(); i++){
       if (inv_svs.size() <= fv[i].first) inv_svs.resize(fv[i].first+1);
       inv_svs[fv[i].first].push_back(std::make_pair(svs_id, fv[i].second));
+      touch(fv[i].first);
     }
     alphas.push_back(alpha);
-    margins.push_back(0.f);
   }
 
   // kernelized passive agressive 
@@ -272,6 +469,7 @@ namespace oll_tool{
       }
       w[fv[i].first] += fv[i].second * alpha * y * cov[fv[i].first];
       cov[fv[i].first] = 1.f / (1.f/cov[fv[i].first] + 2.f * alpha * C * fv[i].second * fv[i].second);
+      touch(fv[i].first);
     }
     b += alpha * y * covb * bias;
     covb = 1.f / (1.f/covb + 2.f * alpha * C * bias * bias);
@@ -301,6 +499,54 @@ namespace oll_tool{
     exampleN++;
   }
 
+  int oll::trainExample(const trainMethod tm, const fv_t& fv, const int y){
+    if (!trainable) return inferenceOnly();
+    if (tm == P){
+      trainExample(P_s(), fv, y);
+    } else if (tm == AP){
+      trainExample(AP_s(), fv, y);
+    } else if (tm == PA){
+      trainExample(PA_s(), fv, y);
+    } else if (tm == PA1){
+      trainExample(PA1_s(), fv, y);
+    } else if (tm == PA2){
+      trainExample(PA2_s(), fv, y);
+    } else if (tm == PAK){
+      trainExample(PAK_s(), fv, y);
+    } else if (tm == CW){
+      trainExample(CW_s(), fv, y);
+    } else if (tm == AL){
+      trainExample(AL_s(), fv, y);
+    } else {
+      errorLog << "unknown trainMethod " << tm;
+      return -1;
+    }
+    return 0;
+  }
+
+  int oll::trainFile(const trainMethod tm, const char* filename, const int iter, const bool verb, const bool shuffle,
+		     const int threadN, const parallelMethod pm, trainControl* ctl){
+    if (tm == P){
+      return trainFile(P_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    } else if (tm == AP){
+      return trainFile(AP_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    } else if (tm == PA){
+      return trainFile(PA_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    } else if (tm == PA1){
+      return trainFile(PA1_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    } else if (tm == PA2){
+      return trainFile(PA2_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    } else if (tm == PAK){
+      return trainFile(PAK_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    } else if (tm == CW){
+      return trainFile(CW_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    } else if (tm == AL){
+      return trainFile(AL_s(), filename, iter, verb, shuffle, threadN, pm, ctl);
+    }
+    errorLog << "unknown trainMethod " << tm;
+    return -1;
+  }
+
   void oll::project(fvec& v){
     float sum = 0.f;
     for (size_t i = 0; i < v.size(); i++){
@@ -314,150 +560,2334 @@ namespace oll_tool{
   }
 
 
-  int oll::save(const char* filename){
-    FILE* fp = fopen(filename, "wb");
-    if (fp == NULL){
-      errorLog << "Unable to open " << filename;
-      return -1;
+  // Model files: a fileHeader, sectionN fileSections and the sections,
+  // each starting at a multiple of SECTION_ALIGN from the beginning of the
+  // file. Numbers are stored in the byte order of the writer, which
+  // byteOrder tells. Vectors are dense arrays of n elements, or for w, w0,
+  // wa and cov, when less than half of the entries differ from fill, the
+  // sorted (int id, float value) pairs of those entries. The PAK index is
+  // the CSR pair svptr (uint64, one more than the ids) and svs (int, float
+  // postings). Every section has the CRC-32 of its bytes, and the header
+  // that of itself (checksum taken as 0) and the section table. Exports
+  // (FLAG_INFERENCE) hold w alone, which may be FLOAT16 (n halves), BFLOAT16
+  // (the upper 16 bits of n floats) or INT8 (a float scale per QUANT_BLOCK
+  // weights, then n signed bytes).
+  namespace {
+    const char FILE_MAGIC[8]  = {'O', 'L', 'L', 'M', 'O', 'D', 'E', 'L'};
+    const char DELTA_MAGIC[8] = {'O', 'L', 'L', 'D', 'E', 'L', 'T', 'A'};
+    const uint32_t FILE_VERSION    = 2;
+    const uint32_t BYTE_ORDER_MARK = 0x01020304;
+    const size_t SECTION_ALIGN     = 64;
+    const uint32_t MAX_SECTIONS    = 64;
+    const uint64_t SPARSE_CHUNK    = (uint64_t)1 << 63; // in delta records
+    const uint32_t FLAG_INFERENCE  = 1; // oll::exportModel: only what classify reads
+    const size_t QUANT_BITS        = 6;
+    const size_t QUANT_BLOCK       = (size_t)1 << QUANT_BITS; // INT8 weights per scale
+
+    enum encoding_t{
+      ENCODING_DENSE  = 0,
+      ENCODING_SPARSE = 1,
+      ENCODING_CHUNKS = 2, // delta files, see oll::saveDelta
+      ENCODING_FLOAT16 = 3,
+      ENCODING_INT8    = 4,
+      ENCODING_BFLOAT16 = 5
+    };
+
+    bool quantized(const uint32_t encoding){
+      return encoding == ENCODING_FLOAT16 || encoding == ENCODING_INT8 || encoding == ENCODING_BFLOAT16;
     }
 
-    if (valWrite(exampleN, fp, "exampleN") == -1) { fclose(fp); return -1;}
-    if (valWrite(featureN, fp, "featureN") == -1) { fclose(fp); return -1;}
-    if (valWrite(updateN , fp, "updateN" ) == -1) { fclose(fp); return -1;}
-    if (valWrite(C,        fp, "C"       ) == -1) { fclose(fp); return -1;}
-    if (valWrite(bias,     fp, "bias"    ) == -1) { fclose(fp); return -1;}
-    if (vecWrite(w,        fp, "w"       ) == -1) { fclose(fp); return -1;}
-    if (valWrite(b,        fp, "b"       ) == -1) { fclose(fp); return -1;}
-    if (vecWrite(w0,       fp, "w0"      ) == -1) { fclose(fp); return -1;}
-    if (valWrite(b0,       fp, "b0"      ) == -1) { fclose(fp); return -1;}
-    if (vecWrite(wa,       fp, "wa"      ) == -1) { fclose(fp); return -1;}
-    if (valWrite(ba,       fp, "ba"      ) == -1) { fclose(fp); return -1;}
-    if (vecWrite(cov,      fp, "cov"     ) == -1) { fclose(fp); return -1;}
-    if (valWrite(covb,     fp, "covb"    ) == -1) { fclose(fp); return -1;}
-    if (vecWrite(alphas,   fp, "alphas"  ) == -1) { fclose(fp); return -1;}
-    if (vecWrite(inv_svs,  fp, "inv_svs" ) == -1) { fclose(fp); return -1;}
+    struct fileHeader{
+      char magic[8];
+      uint32_t version;
+      uint32_t byteOrder;
+      uint32_t flags; // FLAG_INFERENCE or 0
+      uint32_t sectionN;
+      uint64_t exampleN;
+      uint64_t featureN;
+      uint64_t updateN;
+      float C;
+      float bias;
+      float b;
+      float b0;
+      float ba;
+      float covb;
+      uint32_t checksum;
+      // delta files: id of the checkpoint they apply to; compacted
+      // checkpoints: that of the last delta replayed, which they stand for
+      uint32_t base;
+    };
 
-    fclose(fp);
+    struct fileSection{
+      char name[8]; // NUL padded
+      uint64_t offset;
+      uint64_t size; // bytes
+      uint64_t n;    // elements
+      uint32_t encoding;
+      float fill; // value of the entries a sparse section leaves out
+      uint32_t checksum;
+      uint32_t reserved;
+    };
 
-    return 0;
-  }
+    static_assert(sizeof(fileHeader) == 80 && sizeof(fileSection) == 48, "file layout");
+    static_assert(sizeof(std::pair<int, float>) == 8, "postings are stored as int, float");
 
-  int oll::load(const char* filename){
-    FILE* fp = fopen(filename, "rb");
-    if (fp == NULL){
-      errorLog << "Unable to open " << filename;
-      return -1;
+    size_t alignUp(const size_t pos){
+      return (pos + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
     }
 
-    if (valRead(exampleN, fp, "exampleN") == -1) { fclose(fp); return -1;}
-    if (valRead(featureN, fp, "featureN") == -1) { fclose(fp); return -1;}
-    if (valRead(updateN,  fp, "updateN" ) == -1) { fclose(fp); return -1;}
-    if (valRead(C,        fp, "C"       ) == -1) { fclose(fp); return -1;}
-    if (valRead(bias,     fp, "bias"    ) == -1) { fclose(fp); return -1;}
-    if (vecRead(w,        fp, "w"       ) == -1) { fclose(fp); return -1;}
-    if (valRead(b,        fp, "b"       ) == -1) { fclose(fp); return -1;}
-    if (vecRead(w0,       fp, "w0"      ) == -1) { fclose(fp); return -1;}
-    if (valRead(b0,       fp, "b0"      ) == -1) { fclose(fp); return -1;}
-    if (vecRead(wa,       fp, "wa"      ) == -1) { fclose(fp); return -1;}
-    if (valRead(ba,       fp, "ba"      ) == -1) { fclose(fp); return -1;}
-    if (vecRead(cov,      fp, "cov"     ) == -1) { fclose(fp); return -1;}
-    if (valRead(covb,     fp, "covb"    ) == -1) { fclose(fp); return -1;}
-    if (vecRead(alphas,   fp, "alphas"  ) == -1) { fclose(fp); return -1;}
-    if (vecRead(inv_svs,  fp, "inv_svs" ) == -1) { fclose(fp); return -1;}
-    margins.resize(alphas.size()); // buffer
-    fclose(fp);
-    return 0;
-  }
+    bool isSection(const fileSection& s, const char* name){
+      return strncmp(s.name, name, sizeof(s.name)) == 0;
+    }
 
-  float oll::classify(const fv_t& fv) {
-    if (w.size() > 0){ // except AP, PAK
-      return getMargin(w, b, fv);
-    } else if (w0.size() > 0){ // AP
-      return getMargin(w0, b0, fv) - getMargin(wa, ba, fv) / (exampleN+1);
-    } else { // PAK
-      return getMarginK(fv);
+    bool writeZeros(writer& out, size_t n){
+      static const char zeros[SECTION_ALIGN] = {0};
+      while (n > 0){
+	const size_t k = std::min(n, sizeof(zeros));
+	if (!out.write(zeros, k)) return false;
+	n -= k;
+      }
+      return true;
     }
-  }
 
-  int oll::testFile(const char* filename, std::vector<int>& confMat, const bool verb){
-    std::ifstream ifs(filename);
-    if (!ifs){
-      errorLog << "cannot open " << filename;
-      return -1;
+    // CRC-32 (that of zlib), eight bytes per step
+    class crcTable{
+    public:
+      crcTable(){
+	for (uint32_t i = 0; i < 256; i++){
+	  uint32_t c = i;
+	  for (int k = 0; k < 8; k++) c = c & 1 ? 0xedb88320 ^ (c >> 1) : c >> 1;
+	  t[0][i] = c;
+	}
+	for (uint32_t i = 0; i < 256; i++){
+	  for (int k = 1; k < 8; k++) t[k][i] = (t[k-1][i] >> 8) ^ t[0][t[k-1][i] & 0xff];
+	}
+      }
+      uint32_t t[8][256];
+    };
+
+    uint32_t crc32(uint32_t crc, const void* p, size_t n){
+      static const crcTable table;
+      const uint32_t (&t)[8][256] = table.t;
+      const unsigned char* b = (const unsigned char*)p;
+      const uint32_t one = 1;
+      const bool littleEndian = *(const unsigned char*)&one == 1; // else byte by byte
+      crc = ~crc;
+      for (; littleEndian && n >= 8; n -= 8, b += 8){
+	uint32_t lo, hi;
+	memcpy(&lo, b, 4);
+	memcpy(&hi, b + 4, 4);
+	lo ^= crc;
+	crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+	  t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+      }
+      for (; n > 0; n--, b++){
+	crc = t[0][(crc ^ *b) & 0xff] ^ (crc >> 8);
+      }
+      return ~crc;
     }
 
-    std::string line;
-    size_t lineN = 0;
+    // computes the CRC-32 of what is written
+    class crcWriter : public writer{
+    public:
+      crcWriter() : crc(0) {}
+      bool write(const void* p, const size_t size) { crc = crc32(crc, p, size); return true; }
+      uint32_t value() const { return crc; }
+    private:
+      uint32_t crc;
+    };
 
-    confMat.clear();
-    confMat.resize(4); // pp, pn, np, nn
-    while (getline(ifs, line)){
-      lineN++;
-      if (line[0] == '#') continue;
-      
-      fv_t fv;
-      int  y = 0;
-      if (parseLine(line, fv, y) == -1){
-	errorLog << "line:" << lineN;
-	return -1;
+    // passes reads through, computing their CRC-32
+    class crcReader : public reader{
+    public:
+      explicit crcReader(reader& in_) : in(in_), crc(0) {}
+      bool read(void* p, const size_t size){
+	if (!in.read(p, size)) return false;
+	crc = crc32(crc, p, size);
+	return true;
       }
-      
-      const float score = classify(fv);
-      if (verb){
-	resultLog << score << std::endl;
+      size_t left() const { return in.left(); }
+      uint32_t value() const { return crc; }
+    private:
+      reader& in;
+      uint32_t crc;
+    };
+
+    uint32_t headerChecksum(fileHeader h, const fileSection* sections){
+      h.checksum = 0;
+      return crc32(crc32(0, &h, sizeof(h)), sections, h.sectionN * sizeof(fileSection));
+    }
+
+    // Contents of a section to write, as runs of consecutive elements
+    struct sectionData{
+      const char* name;
+      size_t n;
+      size_t elemSize;
+      bool sparsable; // float vector, may be written sparse
+      float fill;     // its untouched entries
+      uint32_t encoding; // of the spans, which n need not count then
+      std::vector<std::pair<const void*, size_t> > spans;
+
+      sectionData(const char* name_, const size_t elemSize_, const bool sparsable_ = false, const float fill_ = 0.f)
+	: name(name_), n(0), elemSize(elemSize_), sparsable(sparsable_), fill(fill_), encoding(ENCODING_DENSE) {}
+      void add(const void* p, const size_t k){
+	if (k == 0) return;
+	spans.push_back(std::make_pair(p, k));
+	n += k;
       }
+      size_t bytes() const {
+	size_t k = 0;
+	for (size_t i = 0; i < spans.size(); i++) k += spans[i].second;
+	return k * elemSize;
+      }
+    };
 
-      if (score >= 0 && y == 1){
-	confMat[0]++;
-      } else if (score < 0 && y == 1){
-	confMat[1]++;
-      } else if (score >= 0 && y == -1){
-	confMat[2]++;
-      } else if (score < 0 && y == -1){
-	confMat[3]++;
-      } else {
-	errorLog << "error score:" << score << " y:" << y << " line:" << lineN;
+    void addSpans(sectionData& d, const fvec& v){
+      d.add(v.data(), v.size());
+    }
+
+    template<class C>
+    void addSpans(sectionData& d, const C& v){ // snapshot chunks
+      for (size_t i = 0; i < v.c.size(); i++){
+	d.add(v.c[i]->data(), v.c[i]->size());
+      }
+    }
+
+    // the sections of save in their order, over the vectors of an oll or
+    // the chunks of a snapshot. svptr is storage for the posting offsets.
+    template<class V, class L>
+    std::vector<sectionData> modelSections(const V& w, const V& w0, const V& wa, const V& cov, const V& alphas,
+					   const L& inv_svs, std::vector<uint64_t>& svptr){
+      std::vector<sectionData> data;
+      data.push_back(sectionData("w",      sizeof(float), true, 0.f));
+      addSpans(data.back(), w);
+      data.push_back(sectionData("w0",     sizeof(float), true, 0.f));
+      addSpans(data.back(), w0);
+      data.push_back(sectionData("wa",     sizeof(float), true, 0.f));
+      addSpans(data.back(), wa);
+      data.push_back(sectionData("cov",    sizeof(float), true, 1.f));
+      addSpans(data.back(), cov);
+      data.push_back(sectionData("alphas", sizeof(float)));
+      addSpans(data.back(), alphas);
+
+      svptr.clear();
+      if (inv_svs.size() > 0) svptr.push_back(0);
+      for (size_t i = 0; i < inv_svs.size(); i++){
+	svptr.push_back(svptr.back() + inv_svs[i].size());
+      }
+      data.push_back(sectionData("svptr",  sizeof(uint64_t)));
+      data.back().add(svptr.data(), svptr.size());
+      data.push_back(sectionData("svs",    sizeof(std::pair<int, float>)));
+      for (size_t i = 0; i < inv_svs.size(); i++){
+	data.back().add(inv_svs[i].data(), inv_svs[i].size());
+      }
+      return data;
+    }
+
+    size_t countSparse(const sectionData& d){
+      size_t n = 0;
+      for (size_t s = 0; s < d.spans.size(); s++){
+	const float* v = (const float*)d.spans[s].first;
+	for (size_t i = 0; i < d.spans[s].second; i++){
+	  if (v[i] != d.fill) n++;
+	}
+      }
+      return n;
+    }
+
+    bool writeSparse(writer& out, const sectionData& d){
+      std::pair<int, float> buf[512];
+      size_t k = 0;
+      size_t id = 0;
+      for (size_t s = 0; s < d.spans.size(); s++){
+	const float* v = (const float*)d.spans[s].first;
+	for (size_t i = 0; i < d.spans[s].second; i++, id++){
+	  if (v[i] == d.fill) continue;
+	  buf[k++] = std::make_pair((int)id, v[i]);
+	  if (k == sizeof(buf) / sizeof(buf[0])){
+	    if (!out.write(buf, sizeof(buf))) return false;
+	    k = 0;
+	  }
+	}
+      }
+      return k == 0 || out.write(buf, k * sizeof(buf[0]));
+    }
+
+    bool writeDense(writer& out, const sectionData& d){
+      for (size_t s = 0; s < d.spans.size(); s++){
+	if (!out.write(d.spans[s].first, d.spans[s].second * d.elemSize)) return false;
+      }
+      return true;
+    }
+
+    // passes writes through, adding their size to ctl.done; fails once
+    // ctl.cancel is set
+    class controlWriter : public writer{
+    public:
+      controlWriter(writer& out_, trainControl& ctl_) : out(out_), ctl(ctl_) {}
+      bool write(const void* p, const size_t size){
+	if (ctl.cancel) return false;
+	ctl.done += size;
+	return out.write(p, size);
+      }
+    private:
+      writer& out;
+      trainControl& ctl;
+    };
+
+    // Writes the header h, the section table and the sections of data. The
+    // sections are laid out and, unless checksums is false, checksummed
+    // first; ctl, if any, counts both passes as total bytes.
+    int writeSections(writer& out, fileHeader& h, const std::vector<sectionData>& data, const bool checksums,
+		      trainControl* ctl, std::ostream& errorLog){
+      const size_t sectionN = data.size();
+      std::vector<fileSection> sections(sectionN);
+      size_t pos = alignUp(sizeof(h) + sectionN * sizeof(fileSection));
+      size_t payload = 0;
+      for (size_t i = 0; i < sectionN; i++){
+	memset(&sections[i], 0, sizeof(sections[i]));
+	memcpy(sections[i].name, data[i].name, std::min(strlen(data[i].name), sizeof(sections[i].name)));
+	sections[i].offset   = pos;
+	sections[i].size     = data[i].bytes();
+	sections[i].n        = data[i].n;
+	sections[i].encoding = data[i].encoding;
+	if (data[i].sparsable){
+	  const size_t sparseN = countSparse(data[i]);
+	  if (sparseN * sizeof(std::pair<int, float>) < sections[i].size){
+	    sections[i].encoding = ENCODING_SPARSE;
+	    sections[i].size     = sparseN * sizeof(std::pair<int, float>);
+	    sections[i].fill     = data[i].fill;
+	  }
+	}
+	payload += sections[i].size;
+	pos = alignUp(pos + sections[i].size);
+      }
+      h.sectionN = sectionN;
+      if (ctl != NULL){
+	ctl->done  = 0;
+	ctl->total = (checksums ? 2 : 1) * payload;
+      }
+
+      auto writeData = [&](writer& o, const size_t i){
+	if (ctl != NULL){
+	  controlWriter c(o, *ctl);
+	  return sections[i].encoding == ENCODING_SPARSE ? writeSparse(c, data[i]) : writeDense(c, data[i]);
+	}
+	return sections[i].encoding == ENCODING_SPARSE ? writeSparse(o, data[i]) : writeDense(o, data[i]);
+      };
+      auto cancelled = [&](){
+	if (ctl == NULL || !ctl->cancel) return false;
+	errorLog << "cancelled";
+	return true;
+      };
+      if (checksums){
+	for (size_t i = 0; i < sectionN; i++){
+	  crcWriter crc;
+	  writeData(crc, i);
+	  if (cancelled()) return -1;
+	  sections[i].checksum = crc.value();
+	}
+	h.checksum = headerChecksum(h, sections.data());
+      }
+
+      if (!out.write(&h, sizeof(h)) || !out.write(sections.data(), sectionN * sizeof(fileSection))){
+	errorLog << "fwrite error header";
 	return -1;
       }
+      pos = sizeof(h) + sectionN * sizeof(fileSection);
+      for (size_t i = 0; i < sectionN; i++){
+	if (!writeZeros(out, sections[i].offset - pos) || !writeData(out, i)){
+	  if (!cancelled()) errorLog << "fwrite error " << data[i].name;
+	  return -1;
+	}
+	pos = sections[i].offset + sections[i].size;
+      }
+      return 0;
     }
 
-    return 0;
-  }
+    fileHeader modelHeader(){
+      fileHeader h;
+      memset(&h, 0, sizeof(h));
+      memcpy(h.magic, FILE_MAGIC, sizeof(h.magic));
+      h.version   = FILE_VERSION;
+      h.byteOrder = BYTE_ORDER_MARK;
+      return h;
+    }
 
-  std::string oll::getErrorLog() const{
-    return errorLog.str();
-  }
+    // the dense vector of s, false when it cannot be read. The whole
+    // section is read even if an id does not increase or is not less than
+    // s.n, which clears valid.
+    bool readSparse(fvec& v, const fileSection& s, reader& in, bool& valid){
+      std::pair<int, float> buf[512];
+      const size_t bufN = sizeof(buf) / sizeof(buf[0]);
+      valid = s.size % sizeof(buf[0]) == 0 && s.n <= (uint64_t)INT_MAX + 1;
+      if (!valid) return true;
+      v.assign(s.n, s.fill);
+      int64_t prev = -1;
+      for (uint64_t left = s.size / sizeof(buf[0]); left > 0; ){
+	const size_t k = std::min(left, (uint64_t)bufN);
+	if (!in.read(buf, k * sizeof(buf[0]))) return false;
+	for (size_t i = 0; valid && i < k; i++){
+	  valid = buf[i].first > prev && (uint64_t)buf[i].first < s.n;
+	  if (valid) v[buf[i].first] = buf[i].second;
+	  prev = buf[i].first;
+	}
+	left -= k;
+      }
+      return true;
+    }
 
-  std::string oll::getResultLog() const{
-    return resultLog.str();
-  }
+    // IEEE half of f, rounded to nearest even; the largest finite half
+    // beyond its range
+    uint16_t toHalf(const float f){
+      uint32_t x;
+      memcpy(&x, &f, sizeof(x));
+      const uint16_t sign = (x >> 16) & 0x8000;
+      const uint32_t a = x & 0x7fffffff;
+      if (a > 0x7f800000) return sign | 0x7e00; // NaN
+      if (a >= 0x477ff000) return sign | 0x7bff; // would round to 65520 or more
+      if (a < 0x38800000){ // subnormal half: multiples of 2^-24
+	return sign | (uint16_t)lrintf(fabsf(f) * 16777216.f);
+      }
+      uint32_t h = (a >> 13) - (112 << 10); // exponent bias 127 -> 15
+      const uint32_t rest = a & 0x1fff;
+      if (rest > 0x1000 || (rest == 0x1000 && (h & 1))) h++;
+      return sign | (uint16_t)h;
+    }
 
+    inline float fromHalf(const uint16_t h){
+#ifdef __F16C__
+      return _cvtsh_ss(h);
+#else
+      const uint32_t sign = (uint32_t)(h & 0x8000) << 16;
+      const uint32_t e = (h >> 10) & 0x1f;
+      const uint32_t m = h & 0x3ff;
+      if (e == 0){
+	const float f = m * (1.f / 16777216.f);
+	return sign ? -f : f;
+      }
+      const uint32_t x = sign | (e == 31 ? 0x7f800000 | (m << 13) : ((e + 112) << 23) | (m << 13));
+      float f;
+      memcpy(&f, &x, sizeof(f));
+      return f;
+#endif
+    }
 
-  template<>
-  int oll::valRead(fv_t& fv, FILE* fp, const char* name){
-    size_t n = 0;
-    if (valRead(n, fp, name) == -1) return -1;
-    fv.resize(n);
-    for (size_t i = 0; i < n; i++){
-      int id = 0;
-      float val = 0.f;
-      if (valRead(id, fp, name) == -1) return -1;
-      if (valRead(val, fp, name) == -1) return -1;
-      fv[i] = std::make_pair(id, val);
+    // f rounded to nearest even to its upper 16 bits; the largest finite
+    // bfloat16 beyond its range
+    uint16_t toBfloat16(const float f){
+      uint32_t x;
+      memcpy(&x, &f, sizeof(x));
+      const uint16_t sign = (x >> 16) & 0x8000;
+      const uint32_t a = x & 0x7fffffff;
+      if (a > 0x7f800000) return sign | 0x7fc0; // NaN
+      if (a >= 0x7f7f8000) return sign | 0x7f7f; // would round to infinity
+      return (uint16_t)((x + 0x7fff + ((x >> 16) & 1)) >> 16);
     }
-    return 0;
-  }
-  
-  template<>
-  int oll::valWrite(const fv_t& fv, FILE* fp, const char* name){
-    size_t n = fv.size();
-    if (valWrite(n, fp, name) == -1) return -1;
-    for (size_t i = 0; i < fv.size(); i++){
-      int id = fv[i].first;
-      float val = fv[i].second;
-      if (valWrite(id, fp, name) == -1) return -1;
-      if (valWrite(val, fp, name) == -1) return -1;
+
+    inline float fromBfloat16(const uint16_t h){
+      const uint32_t x = (uint32_t)h << 16;
+      float f;
+      memcpy(&f, &x, sizeof(f));
+      return f;
     }
-    return 0;
+
+    size_t quantizedSize(const size_t n, const uint32_t encoding){
+      if (encoding == ENCODING_FLOAT16 || encoding == ENCODING_BFLOAT16) return n * sizeof(uint16_t);
+      return ((n + QUANT_BLOCK - 1) >> QUANT_BITS) * sizeof(float) + n;
+    }
+
+    // the bytes of v in a FLOAT16, BFLOAT16 or INT8 section
+    void quantize(const fvec& v, const uint32_t encoding, std::vector<char>& bytes){
+      bytes.assign(quantizedSize(v.size(), encoding), 0);
+      if (encoding == ENCODING_FLOAT16 || encoding == ENCODING_BFLOAT16){
+	for (size_t i = 0; i < v.size(); i++){
+	  const uint16_t h = encoding == ENCODING_FLOAT16 ? toHalf(v[i]) : toBfloat16(v[i]);
+	  memcpy(&bytes[i * sizeof(h)], &h, sizeof(h));
+	}
+	return;
+      }
+      const size_t blockN = (v.size() + QUANT_BLOCK - 1) >> QUANT_BITS;
+      int8_t* q = (int8_t*)&bytes[blockN * sizeof(float)];
+      for (size_t k = 0; k < blockN; k++){
+	const size_t begin = k << QUANT_BITS;
+	const size_t end   = std::min(v.size(), begin + QUANT_BLOCK);
+	float m = 0.f;
+	for (size_t i = begin; i < end; i++) m = std::max(m, fabsf(v[i]));
+	const float scale = m / 127.f;
+	memcpy(&bytes[k * sizeof(float)], &scale, sizeof(scale));
+	for (size_t i = begin; scale > 0.f && i < end; i++){
+	  q[i] = (int8_t)std::max(-127.f, std::min(127.f, rintf(v[i] / scale)));
+	}
+      }
+    }
+
+    // the float vector of a quantized section s, false when it
+    // cannot be read; valid is cleared for a size that does not fit s.n
+    bool readQuantized(fvec& v, const fileSection& s, reader& in, bool& valid){
+      valid = s.n <= s.size && s.size == quantizedSize(s.n, s.encoding);
+      if (!valid) return true;
+      if (s.size > in.left()) return false;
+      std::vector<char> bytes(s.size);
+      if (s.size > 0 && !in.read(&bytes[0], s.size)) return false;
+      v.resize(s.n);
+      if (s.encoding == ENCODING_FLOAT16 || s.encoding == ENCODING_BFLOAT16){
+	for (size_t i = 0; i < v.size(); i++){
+	  uint16_t h;
+	  memcpy(&h, &bytes[i * sizeof(h)], sizeof(h));
+	  v[i] = s.encoding == ENCODING_FLOAT16 ? fromHalf(h) : fromBfloat16(h);
+	}
+	return true;
+      }
+      const size_t blockN = (v.size() + QUANT_BLOCK - 1) >> QUANT_BITS;
+      const int8_t* q = (const int8_t*)&bytes[blockN * sizeof(float)];
+      for (size_t i = 0; i < v.size(); i++){
+	float scale;
+	memcpy(&scale, &bytes[(i >> QUANT_BITS) * sizeof(float)], sizeof(scale));
+	v[i] = scale * q[i];
+      }
+      return true;
+    }
+
+    // reads prefix first, then in
+    class prefixReader : public reader{
+    public:
+      prefixReader(const char* prefix_, const size_t size_, reader& in_) : prefix(prefix_), size(size_), pos(0), in(in_) {}
+      bool read(void* p, const size_t n){
+	const size_t k = std::min(n, size - pos);
+	memcpy(p, prefix + pos, k);
+	pos += k;
+	return k == n || in.read((char*)p + k, n - k);
+      }
+      size_t left() const {
+	const size_t l = in.left();
+	return l == (size_t)-1 ? l : l + size - pos;
+      }
+      bool skip(size_t n){
+	const size_t k = std::min(n, size - pos);
+	pos += k;
+	return k == n || in.skip(n - k);
+      }
+    private:
+      const char* prefix;
+      size_t size;
+      size_t pos;
+      reader& in;
+    };
+  }
+
+  int oll::save(const char* filename){
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    fileWriter out(fp);
+    const int ret = save(out);
+    fclose(fp);
+    return ret;
+  }
+
+  int oll::saveLegacy(const char* filename){
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    fileWriter out(fp);
+    const int ret = saveLegacy(out);
+    fclose(fp);
+    return ret;
+  }
+
+  int oll::load(const char* filename, const loadMode mode){
+    FILE* fp = fopen(filename, "rb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    fileReader in(fp);
+    const int ret = load(in, mode);
+    fclose(fp);
+    return ret;
+  }
+
+  size_t oll::saveSize(){
+    countWriter out;
+    save(out);
+    return out.size();
+  }
+
+  int oll::save(char* buf, const size_t size){
+    memWriter out(buf, size);
+    if (save(out) == -1) return -1;
+    if (out.tell() != size){
+      errorLog << "buffer size " << size << " != " << out.tell();
+      return -1;
+    }
+    return 0;
+  }
+
+  int oll::load(const char* buf, const size_t size, const loadMode mode){
+    memReader in(buf, size);
+    return load(in, mode);
+  }
+
+  int oll::vecWrite(const std::vector<fv_t>& v, writer& out, const char* name){
+    static_assert(sizeof(std::pair<int, float>) == sizeof(int) + sizeof(float), "postings are written as int, float");
+    size_t n = v.size();
+    if (valWrite(n, out, name) == -1) return -1;
+    for (size_t i = 0; i < v.size(); i++){
+      if (vecWrite(v[i], out, name) == -1) return -1;
+    }
+    return 0;
+  }
+
+  int oll::vecRead(std::vector<fv_t>& v, reader& in, const char* name){
+    size_t n = 0;
+    if (valRead(n, in, name) == -1) return -1;
+    if (n > in.left() / sizeof(size_t)){ // every list takes its length at least
+      errorLog << "fread error " << name;
+      return -1;
+    }
+    v.clear();
+    v.resize(n);
+    for (size_t i = 0; i < n; i++){
+      if (vecRead(v[i], in, name) == -1) return -1;
+    }
+    return 0;
+  }
+
+  int oll::save(writer& out){
+    uint32_t id = 0;
+    return saveSections(out, id, 0);
+  }
+
+  int oll::saveSections(writer& out, uint32_t& id, const uint32_t base){
+    std::vector<uint64_t> svptr;
+    const std::vector<sectionData> data = modelSections(w, w0, wa, cov, alphas, inv_svs, svptr);
+    fileHeader h = modelHeader();
+    h.exampleN = exampleN;
+    h.featureN = featureN;
+    h.updateN  = updateN;
+    h.C    = C;
+    h.bias = bias;
+    h.b    = b;
+    h.b0   = b0;
+    h.ba   = ba;
+    h.covb = covb;
+    h.base = base;
+    const bool checksums = dynamic_cast<countWriter*>(&out) == NULL; // saveSize needs none
+    if (writeSections(out, h, data, checksums, NULL, errorLog) == -1) return -1;
+    id = base != 0 ? base : h.checksum;
+    return 0;
+  }
+
+  int oll::saveLegacy(writer& out){
+    if (valWrite(exampleN, out, "exampleN") == -1) return -1;
+    if (valWrite(featureN, out, "featureN") == -1) return -1;
+    if (valWrite(updateN , out, "updateN" ) == -1) return -1;
+    if (valWrite(C,        out, "C"       ) == -1) return -1;
+    if (valWrite(bias,     out, "bias"    ) == -1) return -1;
+    if (vecWrite(w,        out, "w"       ) == -1) return -1;
+    if (valWrite(b,        out, "b"       ) == -1) return -1;
+    if (vecWrite(w0,       out, "w0"      ) == -1) return -1;
+    if (valWrite(b0,       out, "b0"      ) == -1) return -1;
+    if (vecWrite(wa,       out, "wa"      ) == -1) return -1;
+    if (valWrite(ba,       out, "ba"      ) == -1) return -1;
+    if (vecWrite(cov,      out, "cov"     ) == -1) return -1;
+    if (valWrite(covb,     out, "covb"    ) == -1) return -1;
+    if (vecWrite(alphas,   out, "alphas"  ) == -1) return -1;
+    if (vecWrite(inv_svs,  out, "inv_svs" ) == -1) return -1;
+    return 0;
+  }
+
+  // The file is read into a model aside and swapped in once all of it has
+  // been checked, so a load that fails leaves this model as it was.
+  int oll::load(reader& in, const loadMode mode){
+    char magic[sizeof(FILE_MAGIC)];
+    if (!in.read(magic, sizeof(magic))){
+      errorLog << "fread error header";
+      return -1;
+    }
+    if (memcmp(magic, DELTA_MAGIC, sizeof(magic)) == 0){
+      errorLog << "a delta file, see loadDelta";
+      return -1;
+    }
+    prefixReader all(magic, sizeof(magic), in);
+    oll loaded;
+    loaded.trainable = mode == TRAINING;
+    uint32_t id = 0;
+    const int ret = memcmp(magic, FILE_MAGIC, sizeof(magic)) != 0 ? loaded.loadLegacy(all) : loaded.loadSections(all, mode, id);
+    if (ret == -1){
+      errorLog << loaded.errorLog.str();
+      return -1;
+    }
+    swapParams(loaded);
+    trainable = loaded.trainable;
+    waRest.clear();
+    lastSnapshot.reset(); // nothing can be shared with the previous state
+    markCheckpoint(id);
+    return 0;
+  }
+
+  void oll::swapParams(oll& o){
+    std::swap(exampleN, o.exampleN);
+    std::swap(featureN, o.featureN);
+    std::swap(updateN,  o.updateN);
+    std::swap(C,    o.C);
+    std::swap(bias, o.bias);
+    w.swap(o.w);
+    std::swap(b, o.b);
+    w0.swap(o.w0);
+    std::swap(b0, o.b0);
+    wa.swap(o.wa);
+    std::swap(ba, o.ba);
+    alphas.swap(o.alphas);
+    inv_svs.swap(o.inv_svs);
+    cov.swap(o.cov);
+    std::swap(covb, o.covb);
+  }
+
+  // Sections are read in file order, each checked against its checksum;
+  // unknown ones and those the mode leaves out are skipped unread.
+  int oll::loadSections(reader& in, const loadMode mode, uint32_t& id){
+    fileHeader h;
+    if (!in.read(&h, sizeof(h))){
+      errorLog << "fread error header";
+      return -1;
+    }
+    if (h.byteOrder != BYTE_ORDER_MARK){
+      errorLog << "model written with another byte order";
+      return -1;
+    }
+    if (h.version != FILE_VERSION || h.sectionN > MAX_SECTIONS){
+      errorLog << "unsupported model version " << h.version;
+      return -1;
+    }
+    std::vector<fileSection> sections(h.sectionN);
+    if (h.sectionN > 0 && !in.read(&sections[0], h.sectionN * sizeof(fileSection))){
+      errorLog << "fread error sections";
+      return -1;
+    }
+    if (h.checksum != headerChecksum(h, sections.data())){
+      errorLog << "checksum mismatch in header";
+      return -1;
+    }
+    id = h.base != 0 ? h.base : h.checksum;
+    if (h.flags & FLAG_INFERENCE) trainable = false; // an export
+
+    exampleN = h.exampleN;
+    featureN = h.featureN;
+    updateN  = h.updateN;
+    C    = h.C;
+    bias = h.bias;
+    b    = h.b;
+    b0   = h.b0;
+    ba   = h.ba;
+    covb = h.covb;
+
+    std::vector<uint64_t> svptr;
+    std::vector<std::pair<int, float> > svs;
+    size_t pos = sizeof(h) + h.sectionN * sizeof(fileSection);
+    std::vector<size_t> order(sections.size());
+    for (size_t i = 0; i < order.size(); i++) order[i] = i;
+    std::sort(order.begin(), order.end(), [&](const size_t i, const size_t j){ return sections[i].offset < sections[j].offset; });
+    for (size_t k = 0; k < order.size(); k++){
+      const fileSection& s = sections[order[k]];
+      const std::string name(s.name, strnlen(s.name, sizeof(s.name)));
+      if (s.offset < pos){
+	errorLog << "broken section " << name;
+	return -1;
+      }
+      fvec* v = NULL;
+      if      (name == "w")      v = &w;
+      else if (name == "w0")     v = &w0;
+      else if (name == "wa")     v = &wa;
+      else if (name == "cov")    v = &cov;
+      else if (name == "alphas") v = &alphas;
+      else if (name != "svptr" && name != "svs") continue;
+      if (mode == INFERENCE && name == "cov") continue; // classify does not read it
+      if (!in.skip(s.offset - pos)){
+	errorLog << "fread error " << name;
+	return -1;
+      }
+      pos = s.offset;
+
+      crcReader crc(in);
+      int ret = 0;
+      bool valid = true;
+      if (s.encoding == ENCODING_SPARSE){
+	if (v == NULL || v == &alphas){
+	  errorLog << "broken section " << name;
+	  return -1;
+	}
+	ret = readSparse(*v, s, crc, valid) ? 0 : -1;
+      } else if (quantized(s.encoding)){
+	if (v != &w){
+	  errorLog << "broken section " << name;
+	  return -1;
+	}
+	ret = readQuantized(w, s, crc, valid) ? 0 : -1;
+      } else if (s.encoding != ENCODING_DENSE){
+	errorLog << "broken section " << name;
+	return -1;
+      } else if (v != NULL){
+	ret = sectionRead(*v,    s.n, s.size, crc);
+      } else if (name == "svptr"){
+	ret = sectionRead(svptr, s.n, s.size, crc);
+      } else {
+	ret = sectionRead(svs,   s.n, s.size, crc);
+      }
+      if (ret == -1){
+	errorLog << "fread error " << name;
+	return -1;
+      }
+      if (crc.value() != s.checksum){
+	errorLog << "checksum mismatch in section " << name;
+	return -1;
+      }
+      if (!valid){
+	errorLog << "broken section " << name;
+	return -1;
+      }
+      pos += s.size;
+    }
+
+    if (!svptr.empty()){
+      if (svptr[0] != 0 || svptr.back() != svs.size()){
+	errorLog << "broken section svptr";
+	return -1;
+      }
+      inv_svs.resize(svptr.size() - 1);
+      for (size_t i = 0; i < inv_svs.size(); i++){
+	if (svptr[i+1] < svptr[i] || svptr[i+1] > svs.size()){
+	  errorLog << "broken section svptr";
+	  return -1;
+	}
+	inv_svs[i].assign(svs.begin() + svptr[i], svs.begin() + svptr[i+1]);
+      }
+    }
+    return 0;
+  }
+
+  int oll::loadLegacy(reader& in){
+    if (valRead(exampleN, in, "exampleN") == -1) return -1;
+    if (valRead(featureN, in, "featureN") == -1) return -1;
+    if (valRead(updateN,  in, "updateN" ) == -1) return -1;
+    if (valRead(C,        in, "C"       ) == -1) return -1;
+    if (valRead(bias,     in, "bias"    ) == -1) return -1;
+    if (vecRead(w,        in, "w"       ) == -1) return -1;
+    if (valRead(b,        in, "b"       ) == -1) return -1;
+    if (vecRead(w0,       in, "w0"      ) == -1) return -1;
+    if (valRead(b0,       in, "b0"      ) == -1) return -1;
+    if (vecRead(wa,       in, "wa"      ) == -1) return -1;
+    if (valRead(ba,       in, "ba"      ) == -1) return -1;
+    if (vecRead(cov,      in, "cov"     ) == -1) return -1;
+    if (valRead(covb,     in, "covb"    ) == -1) return -1;
+    if (vecRead(alphas,   in, "alphas"  ) == -1) return -1;
+    if (vecRead(inv_svs,  in, "inv_svs" ) == -1) return -1;
+    return 0;
+  }
+
+  // Delta files have the header of a model file with DELTA_MAGIC, the id
+  // (header checksum) of the checkpoint they follow in base, and sections
+  // encoded as ENCODING_CHUNKS: for w, w0, wa, cov and alphas, records of a
+  // uint64 chunk number and the floats of that chunk (CHUNK_SIZE of them,
+  // fewer in the last chunk of the n elements), or, when less than half of
+  // them differ from fill, the chunk number with SPARSE_CHUNK set, a uint64
+  // count and that many (int id, float value) pairs; for svs, records of a
+  // chunk number, the uint64 lengths of its posting lists and the postings.
+  // Sections are contiguous, there is no alignment.
+
+  void oll::markCheckpoint(const uint32_t id){
+    checkpointId = id;
+    checkpointAlphaN = alphas.size();
+    checkpointExampleN = exampleN;
+    checkpointStamp = editStamp++; // later changes are newer than the checkpoint
+  }
+
+  void oll::changedChunks(const size_t n, std::vector<size_t>& chunks) const {
+    chunks.clear();
+    for (size_t c = 0; c * CHUNK_SIZE < n; c++){
+      if (c < chunkStamps.size() && chunkStamps[c] > checkpointStamp) chunks.push_back(c);
+    }
+  }
+
+  int oll::checkpoint(const char* filename, const uint32_t base){
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    fileWriter out(fp);
+    uint32_t id = 0;
+    int ret = saveSections(out, id, base);
+    if (fclose(fp) != 0 && ret == 0){
+      errorLog << "fwrite error " << filename;
+      ret = -1;
+    }
+    if (ret == 0) markCheckpoint(id);
+    return ret;
+  }
+
+  int oll::compact(const char* filename){
+    std::vector<size_t> chunks;
+    changedChunks(std::max(std::max(w.size(), w0.size()), std::max(cov.size(), inv_svs.size())), chunks);
+    if (checkpointId == 0 || !chunks.empty() || alphas.size() != checkpointAlphaN || exampleN != checkpointExampleN){
+      errorLog << "model changed since its last checkpoint or delta";
+      return -1;
+    }
+    return checkpoint(filename, checkpointId);
+  }
+
+  int oll::exportModel(const char* filename, const precision p){
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    fileWriter out(fp);
+    int ret = exportModel(out, p);
+    if (fclose(fp) != 0 && ret == 0){
+      errorLog << "fwrite error " << filename;
+      ret = -1;
+    }
+    return ret;
+  }
+
+  const fvec* oll::linearWeights(fvec& avg, float& bias_) const {
+    if (!inv_svs.empty()) return NULL;
+    bias_ = b;
+    if (w.empty() && !w0.empty()){ // AP: classify reads w0 - wa / (exampleN+1)
+      avg.resize(w0.size());
+      for (size_t i = 0; i < avg.size(); i++){
+	avg[i] = w0[i] - (i < wa.size() ? wa[i] : 0.f) / (exampleN+1);
+      }
+      bias_ = b0 - ba / (exampleN+1);
+      return &avg;
+    }
+    return &w;
+  }
+
+  int oll::exportModel(writer& out, const precision p){
+    fvec avg;
+    float bias_ = 0.f;
+    const fvec* v = linearWeights(avg, bias_);
+    if (v == NULL){
+      errorLog << "PAK models are not linear, save them instead";
+      return -1;
+    }
+
+    // quantized unless the sparse floats of save are smaller
+    std::vector<char> bytes;
+    sectionData d("w", sizeof(float), true, 0.f);
+    addSpans(d, *v);
+    const uint32_t encoding = p == FLOAT16 ? ENCODING_FLOAT16 : p == BFLOAT16 ? ENCODING_BFLOAT16 : ENCODING_INT8;
+    if (p != FLOAT32 && countSparse(d) * sizeof(std::pair<int, float>) >= quantizedSize(v->size(), encoding)){
+      quantize(*v, encoding, bytes);
+      d = sectionData("w", 1);
+      d.add(bytes.data(), bytes.size());
+      d.n = v->size();
+      d.encoding = encoding;
+    }
+
+    fileHeader h = modelHeader();
+    h.flags    = FLAG_INFERENCE;
+    h.exampleN = exampleN;
+    h.featureN = featureN;
+    h.updateN  = updateN;
+    h.C    = C;
+    h.bias = bias;
+    h.b    = bias_;
+    return writeSections(out, h, std::vector<sectionData>(1, d), true, NULL, errorLog);
+  }
+
+  int oll::exportHeader(const char* filename, const std::string& name){
+    std::ofstream ofs(filename);
+    if (!ofs){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    if (exportHeader(ofs, name) == -1) return -1;
+    ofs.close();
+    if (!ofs){
+      errorLog << "fwrite error " << filename;
+      return -1;
+    }
+    return 0;
+  }
+
+  namespace {
+    // float literal that reads back as f
+    std::string floatLiteral(const float f){
+      char buf[32];
+      snprintf(buf, sizeof(buf), "%.9g", f);
+      std::string s = buf;
+      if (s.find_first_of(".e") == std::string::npos) s += ".";
+      return s + "f";
+    }
+
+    // the values of v, eight per line
+    template<class T, class F>
+    void writeTable(std::ostream& out, const std::vector<T>& v, F literal){
+      for (size_t i = 0; i < v.size(); i++){
+	out << (i % 8 == 0 ? "    " : " ") << literal(v[i]) << (i + 1 < v.size() ? "," : "");
+	if (i % 8 == 7 || i + 1 == v.size()) out << "\n";
+      }
+    }
+  }
+
+  // Weights are written dense, or as sorted (id, weight) tables when less
+  // than half of them are not 0. score() adds them up in the order of the
+  // example, as getMargin does.
+  int oll::exportHeader(std::ostream& out, const std::string& name){
+    bool identifier = !name.empty() && !isdigit((unsigned char)name[0]);
+    for (size_t i = 0; i < name.size(); i++){
+      identifier = identifier && (isalnum((unsigned char)name[i]) || name[i] == '_');
+    }
+    if (!identifier){
+      errorLog << "not a C++ identifier: " << name;
+      return -1;
+    }
+    fvec avg;
+    float bias_ = 0.f;
+    const fvec* v = linearWeights(avg, bias_);
+    if (v == NULL){
+      errorLog << "PAK models are not linear, save them instead";
+      return -1;
+    }
+    std::vector<int> ids;
+    fvec weights;
+    for (size_t i = 0; i < v->size(); i++){
+      if (!std::isfinite((*v)[i])){
+	errorLog << "weight " << i << " is not finite";
+	return -1;
+      }
+      if ((*v)[i] == 0.f) continue;
+      ids.push_back((int)i);
+      weights.push_back((*v)[i]);
+    }
+    if (!std::isfinite(bias_)){
+      errorLog << "bias weight is not finite";
+      return -1;
+    }
+    const bool sparse = !ids.empty() && ids.size() * 2 < v->size(); // else no zero-size tables
+    const size_t featureN = ids.empty() ? 0 : v->size();
+
+    std::string guard = "OLL_MODEL_" + name + "_HPP";
+    std::transform(guard.begin(), guard.end(), guard.begin(), ::toupper);
+    out << "// Linear model generated by oll::exportHeader.\n"
+	<< "// score() gives the margin oll::classify gives for the model it was made from.\n"
+	<< "#ifndef " << guard << "\n"
+	<< "#define " << guard << "\n"
+	<< "\n"
+	<< "#include <cstddef>\n"
+	<< "#include <utility>\n"
+	<< "\n"
+	<< "namespace " << name << "{\n"
+	<< "  constexpr std::size_t featureN = " << featureN << "; // other ids weigh 0\n"
+	<< "  constexpr float b = " << floatLiteral(bias_) << "; // bias weight\n";
+    if (sparse){
+      out << "  constexpr std::size_t weightN = " << ids.size() << ";\n"
+	  << "  constexpr int ids[weightN] = {\n";
+      writeTable(out, ids, [](const int id){ return std::to_string(id); });
+      out << "  };\n"
+	  << "  constexpr float weights[weightN] = {\n";
+      writeTable(out, weights, floatLiteral);
+      out << "  };\n"
+	  << "\n"
+	  << "  inline float weight(const int id){\n"
+	  << "    std::size_t lo = 0, hi = weightN;\n"
+	  << "    while (lo < hi){\n"
+	  << "      const std::size_t mid = (lo + hi) / 2;\n"
+	  << "      if (ids[mid] < id) lo = mid + 1; else hi = mid;\n"
+	  << "    }\n"
+	  << "    return lo < weightN && ids[lo] == id ? weights[lo] : 0.f;\n"
+	  << "  }\n";
+    } else {
+      out << "  constexpr float w[" << std::max(featureN, (size_t)1) << "] = {\n";
+      writeTable(out, featureN > 0 ? *v : fvec(1, 0.f), floatLiteral);
+      out << "  };\n"
+	  << "\n"
+	  << "  constexpr float weight(const int id){\n"
+	  << "    return id >= 0 && (std::size_t)id < featureN ? w[id] : 0.f;\n"
+	  << "  }\n";
+    }
+    out << "\n"
+	<< "  // margin of n (id, value) pairs\n"
+	<< "  inline float score(const std::pair<int, float>* fv, const std::size_t n){\n"
+	<< "    float s = b;\n"
+	<< "    for (std::size_t i = 0; i < n; i++) s += weight(fv[i].first) * fv[i].second;\n"
+	<< "    return s;\n"
+	<< "  }\n"
+	<< "\n"
+	<< "  // margin of the dense example x[0, n)\n"
+	<< "  inline float score(const float* x, const std::size_t n){\n"
+	<< "    float s = b;\n"
+	<< "    for (std::size_t i = 0; i < n && i < featureN; i++) s += weight((int)i) * x[i];\n"
+	<< "    return s;\n"
+	<< "  }\n"
+	<< "\n"
+	<< "  // a vector of (id, value) pairs, such as oll_tool::fv_t\n"
+	<< "  template<class FV>\n"
+	<< "  inline float score(const FV& fv){\n"
+	<< "    return score(fv.data(), fv.size());\n"
+	<< "  }\n"
+	<< "}\n"
+	<< "\n"
+	<< "#endif\n";
+    if (!out){
+      errorLog << "write error " << name;
+      return -1;
+    }
+    return 0;
+  }
+
+  int oll::saveDelta(const char* filename){
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    fileWriter out(fp);
+    int ret = saveDelta(out);
+    if (fclose(fp) != 0 && ret == 0){
+      errorLog << "fwrite error " << filename;
+      ret = -1;
+    }
+    return ret;
+  }
+
+  int oll::loadDelta(const char* filename){
+    FILE* fp = fopen(filename, "rb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    fileReader in(fp);
+    const int ret = loadDelta(in);
+    fclose(fp);
+    return ret;
+  }
+
+  int oll::saveDelta(writer& out){
+    if (checkpointId == 0){
+      errorLog << "no checkpoint to write a delta against";
+      return -1;
+    }
+    struct data_t{
+      const char* name;
+      const fvec* v;  // NULL: svs
+      float fill;     // of elements added since the checkpoint
+      size_t n;
+      std::vector<size_t> chunks;
+      std::vector<size_t> sparseN; // per chunk, SIZE_MAX: dense
+    };
+    data_t data[] = {
+      {"w",      &w,      0.f, w.size(),       std::vector<size_t>(), std::vector<size_t>()},
+      {"w0",     &w0,     0.f, w0.size(),      std::vector<size_t>(), std::vector<size_t>()},
+      {"wa",     &wa,     0.f, wa.size(),      std::vector<size_t>(), std::vector<size_t>()},
+      {"cov",    &cov,    1.f, cov.size(),     std::vector<size_t>(), std::vector<size_t>()},
+      {"alphas", &alphas, 0.f, alphas.size(),  std::vector<size_t>(), std::vector<size_t>()},
+      {"svs",    NULL,    0.f, inv_svs.size(), std::vector<size_t>(), std::vector<size_t>()}
+    };
+    const size_t sectionN = sizeof(data) / sizeof(data[0]);
+
+    fileHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, DELTA_MAGIC, sizeof(h.magic));
+    h.version   = FILE_VERSION;
+    h.byteOrder = BYTE_ORDER_MARK;
+    h.sectionN  = sectionN;
+    h.exampleN  = exampleN;
+    h.featureN  = featureN;
+    h.updateN   = updateN;
+    h.C    = C;
+    h.bias = bias;
+    h.b    = b;
+    h.b0   = b0;
+    h.ba   = ba;
+    h.covb = covb;
+    h.base = checkpointId;
+
+    fileSection sections[sectionN];
+    size_t pos = sizeof(h) + sizeof(sections);
+    for (size_t i = 0; i < sectionN; i++){
+      data_t& d = data[i];
+      if (d.v != &alphas){
+	changedChunks(d.n, d.chunks);
+      } else if (d.n > checkpointAlphaN){ // alphas only grow
+	for (size_t c = checkpointAlphaN / CHUNK_SIZE; c * CHUNK_SIZE < d.n; c++) d.chunks.push_back(c);
+      }
+      memset(&sections[i], 0, sizeof(sections[i]));
+      memcpy(sections[i].name, d.name, std::min(strlen(d.name), sizeof(sections[i].name)));
+      sections[i].offset   = pos;
+      sections[i].n        = d.n;
+      sections[i].encoding = ENCODING_CHUNKS;
+      sections[i].fill     = d.fill;
+      d.sparseN.assign(d.chunks.size(), SIZE_MAX);
+      for (size_t k = 0; k < d.chunks.size(); k++){
+	const size_t begin = d.chunks[k] * CHUNK_SIZE;
+	const size_t end   = std::min(begin + CHUNK_SIZE, d.n);
+	sections[i].size += sizeof(uint64_t);
+	if (d.v != NULL){
+	  size_t m = 0;
+	  for (size_t j = begin; j < end; j++){
+	    if ((*d.v)[j] != d.fill) m++;
+	  }
+	  if (sizeof(uint64_t) + m * sizeof(std::pair<int, float>) < (end - begin) * sizeof(float)){
+	    d.sparseN[k] = m;
+	    sections[i].size += sizeof(uint64_t) + m * sizeof(std::pair<int, float>);
+	  } else {
+	    sections[i].size += (end - begin) * sizeof(float);
+	  }
+	  continue;
+	}
+	sections[i].size += (end - begin) * sizeof(uint64_t);
+	for (size_t j = begin; j < end; j++){
+	  sections[i].size += inv_svs[j].size() * sizeof(std::pair<int, float>);
+	}
+      }
+      pos += sections[i].size;
+    }
+
+    std::vector<std::pair<int, float> > buf(CHUNK_SIZE); // entries of a sparse chunk
+    std::vector<uint64_t> lens(CHUNK_SIZE);
+    auto writeData = [&](writer& o, const size_t i){
+      const data_t& d = data[i];
+      for (size_t k = 0; k < d.chunks.size(); k++){
+	const uint64_t c = d.chunks[k];
+	const size_t begin = c * CHUNK_SIZE;
+	const size_t end   = std::min(begin + CHUNK_SIZE, d.n);
+	if (d.v != NULL && d.sparseN[k] != SIZE_MAX){
+	  const uint64_t tag = c | SPARSE_CHUNK, m = d.sparseN[k];
+	  if (!o.write(&tag, sizeof(tag)) || !o.write(&m, sizeof(m))) return false;
+	  size_t l = 0;
+	  for (size_t j = begin; j < end; j++){
+	    if ((*d.v)[j] != d.fill) buf[l++] = std::make_pair((int)j, (*d.v)[j]);
+	  }
+	  if (l > 0 && !o.write(buf.data(), l * sizeof(buf[0]))) return false;
+	  continue;
+	}
+	if (!o.write(&c, sizeof(c))) return false;
+	if (d.v != NULL){
+	  if (!o.write(&(*d.v)[begin], (end - begin) * sizeof(float))) return false;
+	  continue;
+	}
+	for (size_t j = begin; j < end; j++) lens[j - begin] = inv_svs[j].size();
+	if (!o.write(lens.data(), (end - begin) * sizeof(uint64_t))) return false;
+	for (size_t j = begin; j < end; j++){
+	  const fv_t& l = inv_svs[j];
+	  if (!l.empty() && !o.write(l.data(), l.size() * sizeof(l[0]))) return false;
+	}
+      }
+      return true;
+    };
+    for (size_t i = 0; i < sectionN; i++){
+      crcWriter crc;
+      writeData(crc, i);
+      sections[i].checksum = crc.value();
+    }
+    h.checksum = headerChecksum(h, sections);
+
+    if (!out.write(&h, sizeof(h)) || !out.write(sections, sizeof(sections))){
+      errorLog << "fwrite error header";
+      return -1;
+    }
+    for (size_t i = 0; i < sectionN; i++){
+      if (!writeData(out, i)){
+	errorLog << "fwrite error " << data[i].name;
+	return -1;
+      }
+    }
+    markCheckpoint(h.checksum);
+    return 0;
+  }
+
+  // Every section is read and checked before the model is changed, so a
+  // delta that fails to load leaves the model as it was.
+  int oll::loadDelta(reader& in){
+    fileHeader h;
+    if (!in.read(&h, sizeof(h))){
+      errorLog << "fread error header";
+      return -1;
+    }
+    if (memcmp(h.magic, DELTA_MAGIC, sizeof(h.magic)) != 0){
+      errorLog << "not a delta file";
+      return -1;
+    }
+    if (h.byteOrder != BYTE_ORDER_MARK){
+      errorLog << "model written with another byte order";
+      return -1;
+    }
+    if (h.version != FILE_VERSION || h.sectionN > MAX_SECTIONS){
+      errorLog << "unsupported model version " << h.version;
+      return -1;
+    }
+    std::vector<fileSection> sections(h.sectionN);
+    if (h.sectionN > 0 && !in.read(&sections[0], h.sectionN * sizeof(fileSection))){
+      errorLog << "fread error sections";
+      return -1;
+    }
+    if (h.checksum != headerChecksum(h, sections.data())){
+      errorLog << "checksum mismatch in header";
+      return -1;
+    }
+    if (checkpointId == 0 || h.base != checkpointId){
+      errorLog << "delta does not follow the last checkpoint of this model";
+      return -1;
+    }
+
+    std::vector<std::vector<char> > bufs(sections.size());
+    size_t pos = sizeof(h) + h.sectionN * sizeof(fileSection);
+    for (size_t i = 0; i < sections.size(); i++){
+      const fileSection& s = sections[i];
+      const std::string name(s.name, strnlen(s.name, sizeof(s.name)));
+      if (s.offset != pos || s.size > in.left()){
+	errorLog << "broken section " << name;
+	return -1;
+      }
+      bufs[i].resize(s.size);
+      if (s.size > 0 && !in.read(&bufs[i][0], s.size)){
+	errorLog << "fread error " << name;
+	return -1;
+      }
+      if (crc32(0, bufs[i].data(), s.size) != s.checksum){
+	errorLog << "checksum mismatch in section " << name;
+	return -1;
+      }
+      pos += s.size;
+    }
+
+    // the first pass checks the records, the second applies them
+    std::vector<std::pair<int, float> > e(CHUNK_SIZE); // entries of a sparse chunk
+    for (int pass = 0; pass < 2; pass++){
+      for (size_t i = 0; i < sections.size(); i++){
+	const fileSection& s = sections[i];
+	const std::string name(s.name, strnlen(s.name, sizeof(s.name)));
+	fvec* v = NULL;
+	if      (name == "w")      v = &w;
+	else if (name == "w0")     v = &w0;
+	else if (name == "wa")     v = &wa;
+	else if (name == "cov")    v = &cov;
+	else if (name == "alphas") v = &alphas;
+	else if (name != "svs") continue;
+	if (name == "cov" && !trainable) continue; // not loaded either
+	const size_t prevN = v != NULL ? v->size() : inv_svs.size();
+	if (s.encoding != ENCODING_CHUNKS || s.n < prevN){
+	  errorLog << "broken section " << name;
+	  return -1;
+	}
+	if (pass == 1){
+	  if (v != NULL) v->resize(s.n, s.fill);
+	  else inv_svs.resize(s.n);
+	  if (v == &wa) waRest.clear(); // its chunks are replaced
+	}
+
+	const char* p   = bufs[i].data();
+	const char* end = p + bufs[i].size();
+	int64_t prev = -1;
+	while (p < end){
+	  uint64_t c;
+	  if ((size_t)(end - p) < sizeof(c)) break;
+	  memcpy(&c, p, sizeof(c));
+	  p += sizeof(c);
+	  const bool sparse = (c & SPARSE_CHUNK) != 0;
+	  c &= ~SPARSE_CHUNK;
+	  if ((int64_t)c <= prev || c >= (s.n + CHUNK_SIZE - 1) / CHUNK_SIZE || (sparse && v == NULL)) break;
+	  prev = (int64_t)c;
+	  const size_t begin = c * CHUNK_SIZE;
+	  const size_t k     = std::min((size_t)CHUNK_SIZE, (size_t)s.n - begin);
+	  if (sparse){
+	    uint64_t m;
+	    if ((size_t)(end - p) < sizeof(m)) break;
+	    memcpy(&m, p, sizeof(m));
+	    p += sizeof(m);
+	    if (m > k || (size_t)(end - p) < m * sizeof(std::pair<int, float>)) break;
+	    memcpy((void*)e.data(), p, m * sizeof(e[0]));
+	    size_t j = 0;
+	    for (; j < m; j++){
+	      if (e[j].first < (int)begin || e[j].first >= (int)(begin + k) || (j > 0 && e[j].first <= e[j-1].first)) break;
+	    }
+	    if (j < m) break;
+	    if (pass == 1){
+	      std::fill(v->begin() + begin, v->begin() + begin + k, s.fill);
+	      for (j = 0; j < m; j++) (*v)[e[j].first] = e[j].second;
+	      touch(begin);
+	    }
+	    p += m * sizeof(e[0]);
+	    continue;
+	  }
+	  if (v != NULL){
+	    if ((size_t)(end - p) < k * sizeof(float)) break;
+	    if (pass == 1){
+	      memcpy(&(*v)[begin], p, k * sizeof(float));
+	      touch(begin);
+	    }
+	    p += k * sizeof(float);
+	    continue;
+	  }
+	  if ((size_t)(end - p) < k * sizeof(uint64_t)) break;
+	  const char* lens = p;
+	  p += k * sizeof(uint64_t);
+	  size_t j = 0;
+	  for (; j < k; j++){
+	    uint64_t len;
+	    memcpy(&len, lens + j * sizeof(len), sizeof(len));
+	    if ((uint64_t)(end - p) / sizeof(std::pair<int, float>) < len) break;
+	    if (pass == 1){
+	      fv_t& l = inv_svs[begin + j];
+	      l.resize(len);
+	      if (len > 0) memcpy((void*)&l[0], p, len * sizeof(std::pair<int, float>));
+	    }
+	    p += len * sizeof(std::pair<int, float>);
+	  }
+	  if (j < k) break;
+	  if (pass == 1) touch(begin);
+	}
+	if (p != end){
+	  errorLog << "broken section " << name;
+	  return -1;
+	}
+      }
+    }
+
+    exampleN = h.exampleN;
+    featureN = h.featureN;
+    updateN  = h.updateN;
+    C    = h.C;
+    bias = h.bias;
+    b    = h.b;
+    b0   = h.b0;
+    ba   = h.ba;
+    covb = h.covb;
+    markCheckpoint(h.checksum);
+    return 0;
+  }
+
+  float oll::classify(const fv_t& fv) const {
+    if (w.size() > 0){ // except AP, PAK
+      return getMargin(w, b, fv);
+    } else if (w0.size() > 0){ // AP
+      return getMargin(w0, b0, fv) - getMargin(wa, ba, fv) / (exampleN+1);
+    } else { // PAK
+      return getMarginK(fv);
+    }
+  }
+
+  float oll::classify(const fv_t& fv, fvec& buf) const {
+    if (w.size() > 0 || w0.size() > 0){
+      return classify(fv);
+    } else { // PAK
+      return getMarginK(fv, buf);
+    }
+  }
+
+  void oll::classifyBatch(const std::vector<fv_t>& fvs, fvec& scores, const int threadN) const {
+    scores.resize(fvs.size());
+    forBlocks(fvs.size(), threadN, [&](const size_t begin, const size_t n, fvec& buf){
+	classifyBlock(&fvs[begin], n, &scores[begin], buf);
+      });
+  }
+
+  void oll::classifyBlock(const fv_t* fvs, const size_t n, float* scores, fvec& buf) const {
+    if (w.size() > 0 || w0.size() > 0){ // except PAK
+      for (size_t i = 0; i < n; i++){
+	scores[i] = classify(fvs[i]);
+      }
+    } else { // PAK
+      classifyBlockK(fvs, n, scores, buf);
+    }
+  }
+
+  // Scores a block as (block x features) * (features x support vectors).
+  // When the examples of a block share many features, the support vectors
+  // are processed tile by tile so that the slices of the posting lists
+  // walked for one tile stay in cache for every example of the block.
+  void oll::classifyBlockK(const fv_t* fvs, const size_t n, float* scores, fvec& margin) const {
+    const size_t svN = alphas.size();
+    std::vector<size_t> offsets(n+1, 0);
+    for (size_t i = 0; i < n; i++){
+      offsets[i+1] = offsets[i] + fvs[i].size();
+      scores[i] = 0.f;
+    }
+
+    size_t tileN = svN;
+    if (svN > SV_TILE){
+      std::vector<int> ids;
+      for (size_t i = 0; i < n; i++){
+	for (size_t k = 0; k < fvs[i].size(); k++){
+	  ids.push_back(fvs[i][k].first);
+	}
+      }
+      std::sort(ids.begin(), ids.end());
+      const size_t distinctN = std::unique(ids.begin(), ids.end()) - ids.begin();
+      if (offsets[n] >= BLOCK_REUSE * distinctN) tileN = SV_TILE;
+    }
+    std::vector<size_t> cursors(offsets[n], 0); // position in the posting list of each feature
+    margin.resize(std::min(tileN, svN));
+
+    for (size_t t0 = 0; t0 < svN; t0 += tileN){
+      const size_t t1 = std::min(svN, t0 + tileN);
+      for (size_t i = 0; i < n; i++){
+	std::fill(margin.begin(), margin.begin() + (t1 - t0), 0.f);
+	for (size_t k = 0; k < fvs[i].size(); k++){
+	  const int id = fvs[i][k].first;
+	  if (id < 0 || id >= (int)inv_svs.size()) continue;
+	  const fv_t& ifv = inv_svs[id];
+	  const float val = fvs[i][k].second;
+	  size_t j = cursors[offsets[i] + k];
+	  for (; j < ifv.size() && (size_t)ifv[j].first < t1; j++){
+	    margin[ifv[j].first - t0] += ifv[j].second * val;
+	  }
+	  cursors[offsets[i] + k] = j;
+	}
+
+	float ret = 0.f;
+	for (size_t s = t0; s < t1; s++){
+	  ret += (margin[s - t0] * margin[s - t0]) * alphas[s]; // 2nd polynomial
+	}
+	scores[i] += ret;
+      }
+    }
+  }
+
+  int oll::testFile(const char* filename, std::vector<int>& confMat, const bool verb){
+    std::ifstream ifs(filename);
+    if (!ifs){
+      errorLog << "cannot open " << filename;
+      return -1;
+    }
+
+    std::string line;
+    size_t lineN = 0;
+
+    confMat.clear();
+    confMat.resize(4); // pp, pn, np, nn
+    while (getline(ifs, line)){
+      lineN++;
+      if (line[0] == '#') continue;
+      
+      fv_t fv;
+      int  y = 0;
+      if (parseLine(line, fv, y) == -1){
+	errorLog << "line:" << lineN;
+	return -1;
+      }
+      
+      const float score = classify(fv);
+      if (verb){
+	resultLog << score << std::endl;
+      }
+
+      if (score >= 0 && y == 1){
+	confMat[0]++;
+      } else if (score < 0 && y == 1){
+	confMat[1]++;
+      } else if (score >= 0 && y == -1){
+	confMat[2]++;
+      } else if (score < 0 && y == -1){
+	confMat[3]++;
+      } else {
+	errorLog << "error score:" << score << " y:" << y << " line:" << lineN;
+	return -1;
+      }
+    }
+
+    return 0;
+  }
+
+  std::shared_ptr<const snapshot> oll::makeSnapshot(const bool withCov){
+    const snapshot* prev = lastSnapshot.get();
+    const size_t since = prev ? snapshotStamp : 0;
+    std::shared_ptr<snapshot> s(new snapshot);
+    s->exampleN = exampleN;
+    s->featureN = featureN;
+    s->updateN  = updateN;
+    s->C    = C;
+    s->bias = bias;
+    s->b    = b;
+    s->b0   = b0;
+    s->ba   = ba;
+    s->covb = covb;
+    if (withCov) snapshot::share(cov, prev ? &prev->cov : NULL, s->cov, chunkStamps, since);
+    snapshot::share(w,  prev ? &prev->w  : NULL, s->w,  chunkStamps, since);
+    snapshot::share(w0, prev ? &prev->w0 : NULL, s->w0, chunkStamps, since);
+    snapshot::share(wa, prev ? &prev->wa : NULL, s->wa, chunkStamps, since);
+    snapshot::share(inv_svs, prev ? &prev->inv_svs : NULL, s->inv_svs, chunkStamps, since);
+    snapshot::share(alphas, prev ? &prev->alphas : NULL, s->alphas, std::vector<size_t>(), since); // append only
+
+    snapshotStamp = editStamp++; // later changes are newer than this snapshot
+    lastSnapshot = s;
+    return s;
+  }
+
+  trainJob* oll::saveAsync(const char* filename){
+    const std::shared_ptr<const snapshot> s = makeSnapshot(true);
+    const std::string name(filename);
+    return new trainJob([s, name](trainControl& ctl){ return s->saveFile(name, ctl); });
+  }
+
+  size_t oll::getExampleN() const{
+    return exampleN;
+  }
+
+  bool oll::isTrainable() const{
+    return trainable;
+  }
+
+  std::string oll::getErrorLog() const{
+    return errorLog.str();
+  }
+
+  std::string oll::getResultLog() const{
+    return resultLog.str();
+  }
+
+  const float* oll::getParam(const std::string& name, size_t& n) const {
+    const fvec* v = NULL;
+    const float* x = NULL;
+    if      (name == "w")      v = &w;
+    else if (name == "w0")     v = &w0;
+    else if (name == "wa")     v = &wa;
+    else if (name == "cov")    v = &cov;
+    else if (name == "alphas") v = &alphas;
+    else if (name == "b")      x = &b;
+    else if (name == "b0")     x = &b0;
+    else if (name == "ba")     x = &ba;
+    else if (name == "covb")   x = &covb;
+
+    n = 0;
+    if (v != NULL && v->size() > 0){
+      n = v->size();
+      return &(*v)[0];
+    }
+    if (x != NULL){
+      n = 1;
+      return x;
+    }
+    return NULL;
+  }
+
+
+  template<>
+  int oll::valRead(fv_t& fv, reader& in, const char* name){
+    size_t n = 0;
+    if (valRead(n, in, name) == -1) return -1;
+    if (n > in.left()){
+      errorLog << "fread error " << name;
+      return -1;
+    }
+    fv.resize(n);
+    for (size_t i = 0; i < n; i++){
+      int id = 0;
+      float val = 0.f;
+      if (valRead(id, in, name) == -1) return -1;
+      if (valRead(val, in, name) == -1) return -1;
+      fv[i] = std::make_pair(id, val);
+    }
+    return 0;
+  }
+  
+  template<>
+  int oll::valWrite(const fv_t& fv, writer& out, const char* name){
+    size_t n = fv.size();
+    if (valWrite(n, out, name) == -1) return -1;
+    for (size_t i = 0; i < fv.size(); i++){
+      int id = fv[i].first;
+      float val = fv[i].second;
+      if (valWrite(id, out, name) == -1) return -1;
+      if (valWrite(val, out, name) == -1) return -1;
+    }
+    return 0;
+  }
+
+  template<class T>
+  void snapshot::share(const std::vector<T>& v, const chunks<T>* prev, chunks<T>& next,
+		       const std::vector<size_t>& stamps, const size_t since){
+    next.n = v.size();
+    next.c.resize((v.size() + CHUNK_SIZE - 1) >> CHUNK_BITS);
+    for (size_t i = 0; i < next.c.size(); i++){
+      const size_t begin = i << CHUNK_BITS;
+      const size_t end   = std::min(v.size(), begin + CHUNK_SIZE);
+      const bool changed = i < stamps.size() && stamps[i] > since;
+      if (prev && i < prev->c.size() && prev->c[i]->size() == end - begin && !changed){
+	next.c[i] = prev->c[i];
+      } else {
+	next.c[i].reset(new std::vector<T>(v.begin() + begin, v.begin() + end));
+      }
+    }
+  }
+
+  float snapshot::getMargin(const chunks<float>& v, const float bias_, const fv_t& fv) const {
+    float ret = bias_;
+    for (size_t i = 0; i < fv.size(); i++){
+      if (v.size() <= fv[i].first) continue;
+      ret += v[fv[i].first] * fv[i].second;
+    }
+    return ret;
+  }
+
+  float snapshot::getMarginK(const fv_t& fv, fvec& margins) const {
+    margins.assign(alphas.size(), 0.f);
+
+    for (size_t i = 0; i < fv.size(); i++){
+      const int id = fv[i].first;
+      const float val = fv[i].second;
+      if (id >= inv_svs.size()) continue;
+      const fv_t& ifv = inv_svs[id];
+      for (size_t j = 0; j < ifv.size(); j++){
+	margins[ifv[j].first] += ifv[j].second * val;
+      }
+    }
+
+    float ret = 0.f;
+    for (size_t i = 0; i < margins.size(); i++){
+      ret += (margins[i] * margins[i]) * alphas[i]; // 2nd polynomial
+    }
+    return ret;
+  }
+
+  float snapshot::classify(const fv_t& fv) const {
+    static thread_local fvec margins; // per-thread buffer
+    return classify(fv, margins);
+  }
+
+  float snapshot::classify(const fv_t& fv, fvec& buf) const {
+    if (w.size() > 0){ // except AP, PAK
+      return getMargin(w, b, fv);
+    } else if (w0.size() > 0){ // AP
+      return getMargin(w0, b0, fv) - getMargin(wa, ba, fv) / (exampleN+1);
+    } else { // PAK
+      return getMarginK(fv, buf);
+    }
+  }
+
+  size_t snapshot::getExampleN() const {
+    return exampleN;
+  }
+
+  int snapshot::save(writer& out, trainControl* ctl, std::ostream& errorLog) const {
+    std::vector<uint64_t> svptr;
+    const std::vector<sectionData> data = modelSections(w, w0, wa, cov, alphas, inv_svs, svptr);
+    fileHeader h = modelHeader();
+    h.exampleN = exampleN;
+    h.featureN = featureN;
+    h.updateN  = updateN;
+    h.C    = C;
+    h.bias = bias;
+    h.b    = b;
+    h.b0   = b0;
+    h.ba   = ba;
+    h.covb = covb;
+    return writeSections(out, h, data, true, ctl, errorLog);
+  }
+
+  // The data is flushed to disk before the rename, which replaces filename
+  // atomically on POSIX. Windows cannot rename over a file: filename is
+  // removed first, leaving a moment without it.
+  int snapshot::saveFile(const std::string& filename, trainControl& ctl) const {
+    const std::string tmp = filename + ".tmp";
+    std::ostringstream errorLog;
+    FILE* fp = fopen(tmp.c_str(), "wb");
+    if (fp == NULL){
+      ctl.error = "Unable to open " + tmp;
+      return -1;
+    }
+    fileWriter out(fp);
+    int ret = save(out, &ctl, errorLog);
+#ifndef _WIN32
+    if (ret == 0 && (fflush(fp) != 0 || fsync(fileno(fp)) != 0)){
+      errorLog << "fwrite error " << tmp;
+      ret = -1;
+    }
+#endif
+    if (fclose(fp) != 0 && ret == 0){
+      errorLog << "fwrite error " << tmp;
+      ret = -1;
+    }
+#ifdef _WIN32
+    if (ret == 0) remove(filename.c_str());
+#endif
+    if (ret == 0 && rename(tmp.c_str(), filename.c_str()) != 0){
+      errorLog << "Unable to rename " << tmp << " to " << filename;
+      ret = -1;
+    }
+    if (ret == -1){
+      remove(tmp.c_str());
+      ctl.error = errorLog.str();
+    }
+    return ret;
+  }
+
+  mappedModel::mappedModel() : map(NULL), mapSize(0) {
+    close();
+  }
+
+  mappedModel::~mappedModel(){
+    close();
+  }
+
+  void mappedModel::close(){
+#ifndef _WIN32
+    if (map != NULL) munmap(map, mapSize);
+#endif
+    map = NULL;
+    mapSize = 0;
+    copy.clear();
+    data = NULL;
+    exampleN = 0;
+    w = w0 = wa = alphas = vec();
+    b = b0 = ba = 0.f;
+    svptr = NULL;
+    svptrN = 0;
+    svs = NULL;
+    svsN = 0;
+  }
+
+  int mappedModel::open(const char* filename){
+    close();
+#ifndef _WIN32
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd == -1){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    struct stat st;
+    if (fstat(fd, &st) == -1 || st.st_size == 0){
+      errorLog << "Unable to map " << filename;
+      ::close(fd);
+      return -1;
+    }
+    void* p = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (p == MAP_FAILED){
+      errorLog << "Unable to map " << filename;
+      return -1;
+    }
+    map = p;
+    mapSize = (size_t)st.st_size;
+    const char* buf = (const char*)map;
+#else
+    std::ifstream ifs(filename, std::ios::binary);
+    if (!ifs){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    copy.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+    mapSize = copy.size();
+    const char* buf = copy.data();
+#endif
+    if (parse(buf, mapSize) == -1){
+      close();
+      return -1;
+    }
+    return 0;
+  }
+
+  int mappedModel::attach(const char* buf, const size_t size){
+    close();
+    if (parse(buf, size) == -1){
+      close();
+      return -1;
+    }
+    return 0;
+  }
+
+  int mappedModel::parse(const char* buf, const size_t size){
+    fileHeader h;
+    if (size < sizeof(h) || memcmp(buf, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0){
+      errorLog << "not a model saved by oll::save (load and save older models again)";
+      return -1;
+    }
+    if ((uintptr_t)buf % sizeof(uint64_t) != 0){
+      errorLog << "model buffer not aligned";
+      return -1;
+    }
+    memcpy(&h, buf, sizeof(h));
+    if (h.byteOrder != BYTE_ORDER_MARK){
+      errorLog << "model written with another byte order";
+      return -1;
+    }
+    if (h.version != FILE_VERSION || h.sectionN > MAX_SECTIONS ||
+	sizeof(h) + h.sectionN * sizeof(fileSection) > size){
+      errorLog << "unsupported model version " << h.version;
+      return -1;
+    }
+    const fileSection* sections = (const fileSection*)(buf + sizeof(h));
+    if (h.checksum != headerChecksum(h, sections)){
+      errorLog << "checksum mismatch in header";
+      return -1;
+    }
+
+    data = buf;
+    exampleN = h.exampleN;
+    b  = h.b;
+    b0 = h.b0;
+    ba = h.ba;
+    for (uint32_t i = 0; i < h.sectionN; i++){
+      const fileSection& s = sections[i];
+      if (s.offset > size || s.size > size - s.offset || s.offset % sizeof(uint64_t) != 0 ||
+	  s.encoding == ENCODING_CHUNKS || s.encoding > ENCODING_BFLOAT16){
+	errorLog << "broken section " << std::string(s.name, strnlen(s.name, sizeof(s.name)));
+	return -1;
+      }
+      const char* p = buf + s.offset;
+      vec* v = NULL;
+      if      (isSection(s, "w"))      v = &w;
+      else if (isSection(s, "w0"))     v = &w0;
+      else if (isSection(s, "wa"))     v = &wa;
+      else if (isSection(s, "alphas")) v = &alphas;
+      if (s.encoding == ENCODING_SPARSE){
+	if (v == NULL || v == &alphas || s.size % sizeof(std::pair<int, float>) != 0){
+	  if (isSection(s, "cov")) continue; // not needed to classify
+	  errorLog << "broken section " << std::string(s.name, strnlen(s.name, sizeof(s.name)));
+	  return -1;
+	}
+	v->sparse  = (const std::pair<int, float>*)p;
+	v->sparseN = s.size / sizeof(std::pair<int, float>);
+	v->fill    = s.fill;
+	v->n       = s.n;
+      } else if (quantized(s.encoding)){
+	if (v != &w || s.n > s.size || s.size != quantizedSize(s.n, s.encoding)){
+	  errorLog << "broken section " << std::string(s.name, strnlen(s.name, sizeof(s.name)));
+	  return -1;
+	}
+	if (s.encoding == ENCODING_FLOAT16){
+	  w.half = (const uint16_t*)p;
+	} else if (s.encoding == ENCODING_BFLOAT16){
+	  w.bf16 = (const uint16_t*)p;
+	} else {
+	  w.scales = (const float*)p;
+	  w.q = (const int8_t*)(p + s.size - s.n);
+	}
+	w.n = s.n;
+      } else if (v != NULL && s.size == s.n * sizeof(float)){
+	v->p = (const float*)p;
+	v->n = s.n;
+      } else if (isSection(s, "svptr") && s.size == s.n * sizeof(uint64_t)){
+	svptr  = (const uint64_t*)p;
+	svptrN = s.n;
+      } else if (isSection(s, "svs") && s.size == s.n * sizeof(std::pair<int, float>)){
+	svs  = (const std::pair<int, float>*)p;
+	svsN = s.n;
+      } else if (v != NULL || isSection(s, "svptr") || isSection(s, "svs")){
+	errorLog << "broken section " << std::string(s.name, strnlen(s.name, sizeof(s.name)));
+	return -1;
+      }
+    }
+    return 0;
+  }
+
+  int mappedModel::verify(){
+    if (data == NULL){
+      errorLog << "no model";
+      return -1;
+    }
+    fileHeader h;
+    memcpy(&h, data, sizeof(h));
+    const fileSection* sections = (const fileSection*)(data + sizeof(h));
+    for (uint32_t i = 0; i < h.sectionN; i++){
+      const fileSection& s = sections[i];
+      if (crc32(0, data + s.offset, s.size) != s.checksum){
+	errorLog << "checksum mismatch in section " << std::string(s.name, strnlen(s.name, sizeof(s.name)));
+	return -1;
+      }
+    }
+    return 0;
+  }
+
+  namespace {
+    // bias_ plus the products of fv with the n weights read by weight(id);
+    // instantiated once per storage, the conversion inlined in the loop
+    template<class W>
+    inline float dotDense(const float bias_, const fv_t& fv, const size_t n, W weight){
+      float ret = bias_;
+      for (size_t i = 0; i < fv.size(); i++){
+	const size_t id = (size_t)fv[i].first;
+	if (n <= id) continue;
+	ret += weight(id) * fv[i].second;
+      }
+      return ret;
+    }
+  }
+
+  float mappedModel::getMargin(const vec& v, const float bias_, const fv_t& fv) const {
+    if (v.half != NULL){
+      return dotDense(bias_, fv, v.n, [&v](const size_t id){ return fromHalf(v.half[id]); });
+    } else if (v.bf16 != NULL){
+      return dotDense(bias_, fv, v.n, [&v](const size_t id){ return fromBfloat16(v.bf16[id]); });
+    } else if (v.q != NULL){
+      return dotDense(bias_, fv, v.n, [&v](const size_t id){ return v.scales[id >> QUANT_BITS] * v.q[id]; });
+    } else if (v.sparse == NULL){
+      return dotDense(bias_, fv, v.n, [&v](const size_t id){ return v.p[id]; });
+    }
+    // sparse: the entries are sorted by id
+    float ret = bias_;
+    const std::pair<int, float>* end = v.sparse + v.sparseN;
+    for (size_t i = 0; i < fv.size(); i++){
+      if (v.n <= (size_t)fv[i].first) continue;
+      const std::pair<int, float>* it = std::lower_bound(v.sparse, end, fv[i].first,
+							  [](const std::pair<int, float>& e, const int id){ return e.first < id; });
+      ret += (it != end && it->first == fv[i].first ? it->second : v.fill) * fv[i].second;
+    }
+    return ret;
+  }
+
+  // as oll::getMarginK; the lists are bounds-checked here, not when opening
+  float mappedModel::getMarginK(const fv_t& fv, fvec& margins) const {
+    margins.assign(alphas.n, 0.f);
+    for (size_t i = 0; i < fv.size(); i++){
+      const size_t id = (size_t)fv[i].first;
+      if (id + 1 >= svptrN) continue;
+      const float val = fv[i].second;
+      const uint64_t end = std::min(svptr[id+1], (uint64_t)svsN);
+      for (uint64_t j = svptr[id]; j < end; j++){
+	const size_t sv = (size_t)svs[j].first;
+	if (sv < margins.size()) margins[sv] += svs[j].second * val;
+      }
+    }
+
+    float ret = 0.f;
+    for (size_t i = 0; i < margins.size(); i++){
+      ret += (margins[i] * margins[i]) * alphas.p[i]; // 2nd polynomial
+    }
+    return ret;
+  }
+
+  float mappedModel::classify(const fv_t& fv) const {
+    static thread_local fvec margins; // per-thread buffer
+    return classify(fv, margins);
+  }
+
+  float mappedModel::classify(const fv_t& fv, fvec& buf) const {
+    if (w.n > 0){ // except AP, PAK
+      return getMargin(w, b, fv);
+    } else if (w0.n > 0){ // AP
+      return getMargin(w0, b0, fv) - getMargin(wa, ba, fv) / (exampleN+1);
+    } else { // PAK
+      return getMarginK(fv, buf);
+    }
+  }
+
+  size_t mappedModel::getExampleN() const {
+    return exampleN;
+  }
+
+  std::string mappedModel::getErrorLog() const {
+    return errorLog.str();
+  }
+
+  namespace {
+    // Reads a float section of a model file one window after the other.
+    // Entries past the section read as fill, those a sparse section
+    // leaves out as its own fill. finish tells whether the whole section
+    // was read and matched its checksum.
+    class sectionCursor{
+    public:
+      sectionCursor(FILE* fp_, const fileSection* s_, const float fill_)
+	: fp(fp_), s(s_), fill(fill_), pos(0), crc(0), bufN(0), bufI(0), prev(-1), valid(true) {
+	if (s != NULL){
+	  const uint64_t elemSize = s->encoding == ENCODING_SPARSE ? sizeof(buf[0]) : sizeof(float);
+	  valid = (s->encoding == ENCODING_SPARSE && s->size % elemSize == 0) ||
+	    (s->encoding == ENCODING_DENSE && s->size == s->n * elemSize);
+	}
+      }
+
+      size_t size() const { return s ? s->n : 0; }
+
+      bool read(float* out, const size_t begin, const size_t end){
+	const size_t n = std::max(begin, std::min(end, size()));
+	if (!valid) return false;
+	if (s != NULL && s->encoding == ENCODING_DENSE){
+	  if (n > begin && !fetch(out, (n - begin) * sizeof(float))) return false;
+	} else {
+	  std::fill(out, out + (n - begin), s ? s->fill : fill);
+	  while (true){
+	    if (bufI == bufN){
+	      if (s == NULL || pos == s->size) break;
+	      bufN = std::min((size_t)((s->size - pos) / sizeof(buf[0])), sizeof(buf) / sizeof(buf[0]));
+	      bufI = 0;
+	      if (!fetch(buf, bufN * sizeof(buf[0]))) return false;
+	    }
+	    const int64_t id = buf[bufI].first;
+	    if ((uint64_t)id >= end) break;
+	    if (id <= prev || (uint64_t)id >= s->n || (uint64_t)id < begin){
+	      valid = false;
+	      return false;
+	    }
+	    out[id - begin] = buf[bufI++].second;
+	    prev = id;
+	  }
+	}
+	std::fill(out + (n - begin), out + (end - begin), fill);
+	return true;
+      }
+
+      bool finish() const {
+	return s == NULL || (valid && pos == s->size && bufI == bufN && crc == s->checksum);
+      }
+
+    private:
+      bool fetch(void* p, const size_t k){
+	if (fseeko(fp, (off_t)(s->offset + pos), SEEK_SET) != 0 || fread(p, 1, k, fp) != k) return false;
+	crc = crc32(crc, p, k);
+	pos += k;
+	return true;
+      }
+
+      FILE* fp;
+      const fileSection* s;
+      float fill;
+      uint64_t pos;
+      uint32_t crc;
+      std::pair<int, float> buf[512];
+      size_t bufN;
+      size_t bufI;
+      int64_t prev;
+      bool valid;
+    };
+
+    struct mergeInput{
+      FILE* fp;
+      fileHeader h;
+      std::vector<fileSection> sections;
+      float weight;
+
+      mergeInput() : fp(NULL), weight(0.f) {}
+      ~mergeInput() { if (fp != NULL) fclose(fp); }
+      const fileSection* find(const char* name) const {
+	for (size_t i = 0; i < sections.size(); i++){
+	  if (isSection(sections[i], name) && sections[i].n > 0) return &sections[i];
+	}
+	return NULL;
+      }
+      size_t size(const char* name) const {
+	const fileSection* s = find(name);
+	return s ? s->n : 0;
+      }
+    };
+
+    // what tells the algorithms apart in a saved model
+    enum modelKind{ KIND_EMPTY, KIND_LINEAR, KIND_AP, KIND_CW, KIND_PAK };
+
+    modelKind kindOf(const mergeInput& in){
+      if (in.find("alphas") || in.find("svs")) return KIND_PAK;
+      if (in.find("w0") || in.find("wa")) return KIND_AP;
+      if (in.find("cov")) return KIND_CW;
+      if (in.find("w")) return KIND_LINEAR;
+      return KIND_EMPTY;
+    }
+
+    // CW: means weighted by precision, or plainly where a variance is 0.
+    // w or cov may be NULL.
+    void mergePrecision(const std::vector<float>& weights, const std::vector<const float*>& ws,
+			const std::vector<const float*>& covs, const size_t n, float* w, float* cov){
+      for (size_t i = 0; i < n; i++){
+	float p = 0.f, pw = 0.f, sw = 0.f, sc = 0.f;
+	bool positive = true;
+	for (size_t r = 0; r < weights.size(); r++){
+	  positive = positive && covs[r][i] > 0.f;
+	  if (positive){
+	    p  += weights[r] / covs[r][i];
+	    pw += weights[r] * ws[r][i] / covs[r][i];
+	  }
+	  sw += weights[r] * ws[r][i];
+	  sc += weights[r] * covs[r][i];
+	}
+	if (w != NULL)   w[i]   = positive ? pw / p : sw;
+	if (cov != NULL) cov[i] = positive ? 1.f / p : sc;
+      }
+    }
+
+    void mergeSum(const std::vector<float>& weights, const std::vector<const float*>& xs, const size_t n, float* out){
+      std::fill(out, out + n, 0.f);
+      for (size_t r = 0; r < weights.size(); r++){
+	for (size_t i = 0; i < n; i++) out[i] += weights[r] * xs[r][i];
+      }
+    }
+
+    int seekTo(FILE* fp, const uint64_t pos){
+#ifdef _WIN32
+      return _fseeki64(fp, (__int64)pos, SEEK_SET);
+#else
+      return fseeko(fp, (off_t)pos, SEEK_SET);
+#endif
+    }
+  }
+
+  void modelMerger::add(const char* filename, const float weight){
+    inputs.push_back(std::make_pair(std::string(filename), weight));
+  }
+
+  int modelMerger::merge(const char* filename){
+    if (inputs.empty()){
+      errorLog << "no model to merge";
+      return -1;
+    }
+    std::vector<mergeInput> in(inputs.size());
+    modelKind kind = KIND_EMPTY;
+    for (size_t r = 0; r < in.size(); r++){
+      const char* name = inputs[r].first.c_str();
+      in[r].fp = fopen(name, "rb");
+      if (in[r].fp == NULL){
+	errorLog << "Unable to open " << name;
+	return -1;
+      }
+      fileHeader& h = in[r].h;
+      if (fread(&h, sizeof(h), 1, in[r].fp) != 1 || memcmp(h.magic, FILE_MAGIC, sizeof(h.magic)) != 0 ||
+	  h.flags != 0){
+	errorLog << name << " is not a model saved by oll::save";
+	return -1;
+      }
+      if (h.byteOrder != BYTE_ORDER_MARK || h.version != FILE_VERSION || h.sectionN > MAX_SECTIONS){
+	errorLog << "unsupported model " << name;
+	return -1;
+      }
+      in[r].sections.resize(h.sectionN);
+      if (h.sectionN > 0 && fread(&in[r].sections[0], sizeof(fileSection), h.sectionN, in[r].fp) != h.sectionN){
+	errorLog << "fread error sections of " << name;
+	return -1;
+      }
+      if (h.checksum != headerChecksum(h, in[r].sections.data())){
+	errorLog << "checksum mismatch in header of " << name;
+	return -1;
+      }
+      const modelKind k = kindOf(in[r]);
+      if (k == KIND_PAK){
+	errorLog << "PAK models cannot be merged: " << name;
+	return -1;
+      }
+      if ((k != kind && k != KIND_EMPTY && kind != KIND_EMPTY) || h.bias != in[0].h.bias){
+	errorLog << "models of different algorithms or biases: " << inputs[0].first << ", " << name;
+	return -1;
+      }
+      if (k != KIND_EMPTY) kind = k;
+    }
+
+    fileHeader h = modelHeader();
+    h.C    = in[0].h.C;
+    h.bias = in[0].h.bias;
+    float weightSum = 0.f;
+    for (size_t r = 0; r < in.size(); r++){
+      in[r].weight = inputs[r].second >= 0.f ? inputs[r].second : (float)in[r].h.exampleN;
+      weightSum += in[r].weight;
+      h.exampleN += in[r].h.exampleN;
+      h.updateN  += in[r].h.updateN;
+      h.featureN = std::max(h.featureN, in[r].h.featureN);
+    }
+    std::vector<float> weights(in.size(), 1.f / in.size());
+    std::vector<float> waWeights(in.size()); // wa is rescaled to the summed exampleN
+    for (size_t r = 0; r < in.size(); r++){
+      if (weightSum > 0.f) weights[r] = in[r].weight / weightSum;
+      waWeights[r] = weights[r] * (h.exampleN + 1.f) / (in[r].h.exampleN + 1.f);
+    }
+
+    // the bias weights, merged as one more entry of w, w0, wa and cov
+    std::vector<const float*> bs(in.size()), b0s(in.size()), bas(in.size()), covbs(in.size());
+    for (size_t r = 0; r < in.size(); r++){
+      bs[r]    = &in[r].h.b;
+      b0s[r]   = &in[r].h.b0;
+      bas[r]   = &in[r].h.ba;
+      covbs[r] = &in[r].h.covb;
+    }
+    if (kind == KIND_CW){
+      mergePrecision(weights, bs, covbs, 1, &h.b, &h.covb);
+    } else {
+      mergeSum(weights, bs, 1, &h.b);
+      mergeSum(weights, covbs, 1, &h.covb);
+    }
+    mergeSum(weights, b0s, 1, &h.b0);
+    mergeSum(waWeights, bas, 1, &h.ba);
+
+    FILE* fp = fopen(filename, "wb");
+    if (fp == NULL){
+      errorLog << "Unable to open " << filename;
+      return -1;
+    }
+    auto fail = [&](const std::string& message){
+      errorLog << message;
+      fclose(fp);
+      remove(filename);
+      return -1;
+    };
+
+    const char* names[] = {"w", "w0", "wa", "cov", "alphas", "svptr", "svs"};
+    const size_t sectionN = sizeof(names) / sizeof(names[0]);
+    fileSection sections[sectionN];
+    fileWriter out(fp);
+    size_t pos = alignUp(sizeof(h) + sizeof(sections));
+    if (!writeZeros(out, pos)) return fail("fwrite error header");
+
+    std::vector<fvec> xs(in.size(), fvec(CHUNK_SIZE)), covs(in.size(), fvec(CHUNK_SIZE));
+    std::vector<const float*> xp(in.size()), covp(in.size());
+    for (size_t r = 0; r < in.size(); r++){
+      xp[r]   = xs[r].data();
+      covp[r] = covs[r].data();
+    }
+    fvec merged(CHUNK_SIZE);
+    for (size_t v = 0; v < sectionN; v++){
+      const std::string name = names[v];
+      const bool isCov = name == "cov";
+      size_t n = 0;
+      for (size_t r = 0; r < in.size(); r++){
+	if (v < 4 && (!isCov || kind == KIND_CW)) n = std::max(n, in[r].size(names[v]));
+      }
+      memset(&sections[v], 0, sizeof(sections[v]));
+      memcpy(sections[v].name, names[v], std::min(strlen(names[v]), sizeof(sections[v].name)));
+      sections[v].offset = pos;
+      sections[v].size   = n * sizeof(float);
+      sections[v].n      = n;
+
+      const bool withCov = kind == KIND_CW && (name == "w" || isCov);
+      std::vector<sectionCursor> xc, cc;
+      for (size_t r = 0; r < in.size(); r++){
+	xc.push_back(sectionCursor(in[r].fp, in[r].find(names[v]), isCov ? 1.f : 0.f));
+	if (withCov) cc.push_back(sectionCursor(in[r].fp, in[r].find("cov"), 1.f));
+      }
+      uint32_t crc = 0;
+      for (size_t begin = 0; begin < n; begin += CHUNK_SIZE){
+	const size_t end = std::min(n, begin + CHUNK_SIZE);
+	for (size_t r = 0; r < in.size(); r++){
+	  if (!xc[r].read(&xs[r][0], begin, end) || (withCov && !cc[r].read(&covs[r][0], begin, end))){
+	    return fail("broken section " + name + " in " + inputs[r].first);
+	  }
+	}
+	if (withCov){
+	  mergePrecision(weights, xp, covp, end - begin, isCov ? NULL : &merged[0], isCov ? &merged[0] : NULL);
+	} else {
+	  mergeSum(name == "wa" ? waWeights : weights, xp, end - begin, &merged[0]);
+	}
+	const size_t bytes = (end - begin) * sizeof(float);
+	crc = crc32(crc, &merged[0], bytes);
+	if (!out.write(&merged[0], bytes)) return fail("fwrite error " + name);
+      }
+      for (size_t r = 0; r < in.size(); r++){
+	if (!xc[r].finish() || (withCov && !cc[r].finish())){
+	  return fail("checksum mismatch in section " + name + " of " + inputs[r].first);
+	}
+      }
+      sections[v].checksum = crc;
+      const size_t next = alignUp(pos + sections[v].size);
+      if (!writeZeros(out, next - pos - sections[v].size)) return fail("fwrite error " + name);
+      pos = next;
+    }
+
+    h.sectionN = sectionN;
+    h.checksum = headerChecksum(h, sections);
+    if (seekTo(fp, 0) != 0 || !out.write(&h, sizeof(h)) || !out.write(sections, sizeof(sections))){
+      return fail("fwrite error header");
+    }
+    if (fclose(fp) != 0){
+      errorLog << "fwrite error " << filename;
+      remove(filename);
+      return -1;
+    }
+    return 0;
+  }
+
+  std::string modelMerger::getErrorLog() const {
+    return errorLog.str();
   }
 }
@@ -21,15 +21,37 @@
 //
 
 #include <vector>
+#include <stdint.h>
+#include <cstdio>
+#include <climits>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <memory>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <type_traits>
 
 namespace oll_tool{  
   typedef std::vector<std::pair<int, float> > fv_t; // feature vector
   typedef std::vector<float> fvec;
 
+  const size_t CHUNK_BITS = 12; // snapshots share state in chunks of 4096 slots
+  const size_t CHUNK_SIZE = 1 << CHUNK_BITS;
+  const size_t BATCH_BLOCK = 32; // examples scored together
+
+  class snapshot;
+
+  // Hands out blocks of BATCH_BLOCK items out of n to up to threadN
+  // threads, the calling thread included. f(begin, size, buf) is called
+  // per block; each thread keeps its own buf.
+  template<class F>
+  void forBlocks(const size_t n, const int threadN, F f);
+
   enum trainMethod{
     P  = 0,  // Perceptron
     AP  = 1, // Averaged Perceptron
@@ -40,12 +62,120 @@ namespace oll_tool{
     CW  = 6, // Confidence Weighted     
     AL  = 7  // ALMA HD
   };
+
+  enum parallelMethod{
+    HOGWILD = 0, // lock-free updates of shared weights
+    MIX     = 1  // iterative parameter mixing of per-thread replicas
+  };
+
+  // What oll::load reads of a model file
+  enum loadMode{
+    TRAINING  = 0, // everything, training can go on
+    INFERENCE = 1  // only what classify reads; the model cannot be trained
+  };
+
+  // Storage of the weights in oll::exportModel
+  enum precision{
+    FLOAT32 = 0,
+    FLOAT16 = 1, // IEEE half
+    INT8    = 2, // per 64 weights, a float scale and signed bytes
+    BFLOAT16 = 3 // upper half of the float: its range, 8 bits of mantissa
+  };
   
   int trainFile(const char* trainfile, const char* modelfile, 
-		const trainMethod tm, const float C, const float bias, const int iter, bool verb, bool shuffle);
+		const trainMethod tm, const float C, const float bias, const int iter, bool verb, bool shuffle,
+		const int threadN = 1, const parallelMethod pm = HOGWILD);
 
   int testFile (const char* testfile, const char* modelfile, std::vector<int>& confMat, int verb);
 
+  // Byte streams for oll::save and oll::load
+  class writer{
+  public:
+    virtual ~writer() {}
+    virtual bool write(const void* p, const size_t size) = 0;
+  };
+
+  class reader{
+  public:
+    virtual ~reader() {}
+    virtual bool read(void* p, const size_t size) = 0;
+    virtual size_t left() const = 0; // upper bound of the bytes still readable
+    virtual bool skip(size_t size){
+      char buf[4096];
+      while (size > 0){
+	const size_t k = std::min(size, sizeof(buf));
+	if (!read(buf, k)) return false;
+	size -= k;
+      }
+      return true;
+    }
+  };
+
+  class fileWriter : public writer{
+  public:
+    explicit fileWriter(FILE* fp_) : fp(fp_) {}
+    bool write(const void* p, const size_t size) { return fwrite(p, 1, size, fp) == size; }
+  private:
+    FILE* fp;
+  };
+
+  class fileReader : public reader{
+  public:
+    explicit fileReader(FILE* fp_) : fp(fp_) {}
+    bool read(void* p, const size_t size) { return fread(p, 1, size, fp) == size; }
+    size_t left() const { return (size_t)-1; }
+    bool skip(size_t size) { return size == 0 || (size <= LONG_MAX && fseek(fp, (long)size, SEEK_CUR) == 0); }
+  private:
+    FILE* fp;
+  };
+
+  // counts the bytes instead of storing them
+  class countWriter : public writer{
+  public:
+    countWriter() : n(0) {}
+    bool write(const void* p, const size_t size) { n += size; return true; }
+    size_t size() const { return n; }
+  private:
+    size_t n;
+  };
+
+  class memWriter : public writer{
+  public:
+    memWriter(char* buf_, const size_t size_) : buf(buf_), size(size_), pos(0) {}
+    bool write(const void* p, const size_t n) {
+      if (size - pos < n) return false;
+      memcpy(buf + pos, p, n);
+      pos += n;
+      return true;
+    }
+    size_t tell() const { return pos; }
+  private:
+    char* buf;
+    size_t size;
+    size_t pos;
+  };
+
+  class memReader : public reader{
+  public:
+    memReader(const char* buf_, const size_t size_) : buf(buf_), size(size_), pos(0) {}
+    bool read(void* p, const size_t n) {
+      if (size - pos < n) return false;
+      memcpy(p, buf + pos, n);
+      pos += n;
+      return true;
+    }
+    size_t left() const { return size - pos; }
+    bool skip(size_t n) {
+      if (size - pos < n) return false;
+      pos += n;
+      return true;
+    }
+  private:
+    const char* buf;
+    size_t size;
+    size_t pos;
+  };
+
   // For specializing oll::exampleTrain
   struct P_s {};   // Perceptron
   struct AP_s {};  // Averaged Perceptron
@@ -56,6 +186,143 @@ namespace oll_tool{
   struct CW_s {};  // Confidence Weighted 
   struct AL_s {};  // ALMA HD
 
+  // Learners whose updates touch only the weights of the example, so that
+  // several threads can train them lock-free on a shared w (Hogwild!)
+  template<class T> struct hogwild_s     { enum { ok = 0 }; };
+  template<> struct hogwild_s<P_s>   { enum { ok = 1 }; };
+  template<> struct hogwild_s<PA_s>  { enum { ok = 1 }; };
+  template<> struct hogwild_s<PA1_s> { enum { ok = 1 }; };
+  template<> struct hogwild_s<PA2_s> { enum { ok = 1 }; };
+  template<> struct hogwild_s<CW_s>  { enum { ok = 1 }; };
+
+  // Row sources over the buffers of a matrix, so that rows can be trained
+  // and scored without building fv_t lists first. get() refills a reused fv_t.
+
+  // compressed sparse rows: row i is indices/data[indptr[i], indptr[i+1])
+  template<class I, class V>
+  struct csrRows{
+    const I* indptr;
+    const I* indices;
+    const V* data;
+    size_t n;
+
+    csrRows(const I* indptr_, const I* indices_, const V* data_, const size_t n_)
+      : indptr(indptr_), indices(indices_), data(data_), n(n_) {}
+    size_t size() const { return n; }
+    void get(const size_t i, fv_t& fv) const {
+      fv.clear();
+      for (I k = indptr[i]; k < indptr[i+1]; k++){
+	fv.push_back(std::make_pair((int)indices[k], (float)data[k]));
+      }
+    }
+  };
+
+  // dense n x d matrix, strides in elements; zeros are skipped
+  template<class V>
+  struct denseRows{
+    const V* x;
+    size_t n;
+    size_t d;
+    ptrdiff_t rowStride;
+    ptrdiff_t colStride;
+
+    denseRows(const V* x_, const size_t n_, const size_t d_, const ptrdiff_t rowStride_, const ptrdiff_t colStride_)
+      : x(x_), n(n_), d(d_), rowStride(rowStride_), colStride(colStride_) {}
+    size_t size() const { return n; }
+    void get(const size_t i, fv_t& fv) const {
+      fv.clear();
+      const V* row = x + (ptrdiff_t)i * rowStride;
+      for (size_t j = 0; j < d; j++){
+	const V val = row[(ptrdiff_t)j * colStride];
+	if (val != 0) fv.push_back(std::make_pair((int)j, (float)val));
+      }
+    }
+  };
+
+  // Progress and cancellation of a training run, shared with the threads
+  // watching it. done counts the examples trained out of total; a run
+  // stops at the next example once cancel is set. oll::saveAsync counts
+  // bytes instead and leaves why it failed in error, to be read once the
+  // run is over.
+  struct trainControl{
+    std::atomic<size_t> done;
+    std::atomic<size_t> total;
+    std::atomic<bool> cancel;
+    std::string error;
+
+    trainControl() : done(0), total(0), cancel(false) {}
+  };
+
+  // Training run on a worker thread of its own. f(ctl) trains, reporting
+  // to ctl, and returns 0 or -1. The destructor cancels the run and waits
+  // for it.
+  class trainJob{
+  public:
+    template<class F>
+    explicit trainJob(F f) : finished(false), ret(0) {
+      worker = std::thread([this, f](){
+	  const int r = f(ctl);
+	  std::lock_guard<std::mutex> lock(m);
+	  ret = r;
+	  finished = true;
+	  cv.notify_all();
+	});
+    }
+    ~trainJob();
+
+    trainControl& control() { return ctl; }
+    bool wait(const double timeout); // seconds, < 0 for no limit; true once finished
+    int result(); // f's return value, once finished
+
+  private:
+    trainJob(const trainJob&);
+    trainJob& operator=(const trainJob&);
+
+    trainControl ctl;
+    std::mutex m;
+    std::condition_variable cv;
+    bool finished;
+    int ret;
+    std::thread worker;
+  };
+
+  // Labeled examples stored once in CSR form, to be reused by any number
+  // of fits and evaluations instead of parsing or converting them again
+  class dataset{
+  public:
+    dataset();
+
+    int readFile(const char* filename); // appends the examples of a libsvm file
+    template<class R>
+    void append(const R& rows, const int* ys);
+
+    size_t size() const;
+    void get(const size_t i, fv_t& fv) const;
+    int label(const size_t i) const;
+    std::string getErrorLog() const;
+
+    // Row source over the rows idx[0..n) of a dataset, or over all of
+    // them when idx is NULL. The indices are not copied.
+    struct rows{
+      const dataset* d;
+      const size_t* idx;
+      size_t n;
+
+      rows(const dataset& d_, const size_t* idx_, const size_t n_) : d(&d_), idx(idx_), n(n_) {}
+      size_t size() const { return n; }
+      void get(const size_t i, fv_t& fv) const { d->get(idx ? idx[i] : i, fv); }
+      int label(const size_t i) const { return d->label(idx ? idx[i] : i); }
+      void labels(std::vector<int>& ys) const;
+    };
+
+  private:
+    std::vector<size_t> indptr;
+    std::vector<int> indices;
+    fvec data;
+    std::vector<int> ys;
+    std::ostringstream errorLog;
+  };
+
   class oll{
     static const char* trainMethod_s[];
 
@@ -65,54 +332,191 @@ namespace oll_tool{
 
     template<class T>    
     void trainExample(const T& a, const fv_t& fv, const int y) ;
+    int trainExample(const trainMethod tm, const fv_t& fv, const int y);
         
+    // save writes the sectioned format read by mappedModel; load also
+    // reads the original oll format, which saveLegacy still writes.
+    // Sections carry checksums which load verifies for what it reads;
+    // INFERENCE leaves out what only training needs.
     int save(const char* filename);
-    int load(const char* filename);
-
-    float classify(const fv_t& fv);
+    int load(const char* filename, const loadMode mode = TRAINING);
+    int save(writer& out);
+    int load(reader& in, const loadMode mode = TRAINING);
+    int saveLegacy(const char* filename);
+    int saveLegacy(writer& out);
+
+    // In-memory models: buf of saveSize() bytes receives what save writes
+    size_t saveSize();
+    int save(char* buf, const size_t size);
+    int load(const char* buf, const size_t size, const loadMode mode = TRAINING);
+
+    // Delta checkpoints: checkpoint saves the whole model as save does and
+    // makes it the base; saveDelta writes only the chunks changed since the
+    // last checkpoint, delta or load, and becomes the base in turn. A model
+    // loaded from a checkpoint replays its deltas in order with loadDelta.
+    // compact writes a model that has just replayed deltas as a checkpoint
+    // the deltas still to come apply to.
+    int checkpoint(const char* filename) { return checkpoint(filename, 0); }
+    int compact(const char* filename);
+    int saveDelta(const char* filename);
+    int saveDelta(writer& out);
+    int loadDelta(const char* filename);
+    int loadDelta(reader& in);
+
+    // Inference export: only the weights classify reads (for AP, their
+    // average), stored with precision p. mappedModel scores such files in
+    // place and load reads them for inference only. Not for PAK.
+    int exportModel(const char* filename, const precision p);
+    int exportModel(writer& out, const precision p);
+
+    // C++ header of the same weights as constexpr tables in namespace
+    // name, with inline score() functions computing what classify does.
+    // A model compiled in this way needs neither load nor this library.
+    int exportHeader(const char* filename, const std::string& name);
+    int exportHeader(std::ostream& out, const std::string& name);
+
+    // classify and the margin functions are reentrant, a model can be
+    // shared by several scoring threads as long as no thread trains it
+    float classify(const fv_t& fv) const;
+    float classify(const fv_t& fv, fvec& buf) const; // buf: scratch for PAK
     float getMargin(const fvec& v, const float bias_, const fv_t& fv) const;
-    float getMarginK(const fv_t& fv) ; // kernelized, use margins as buffer
+    float getMarginK(const fv_t& fv) const; // kernelized, uses a per-thread buffer
+    float getMarginK(const fv_t& fv, fvec& margins) const;
+    void classifyBatch(const std::vector<fv_t>& fvs, fvec& scores, const int threadN = 1) const;
+    template<class R>
+    void classifyRows(const R& rows, float* scores, const int threadN = 1) const; // scores: rows.size()
     float getVariance(const fv_t& fv) const;
 
     float getNorm(const fv_t& fv) const;
     
+    // threadN > 1 trains with threadN threads. HOGWILD applies to P, PA,
+    // PA1, PA2 and CW; MIX is deterministic for a fixed threadN and applies
+    // to all learners but PAK. The other cases are trained serially.
+    // With ctl, a cancelled run returns -1; MIX runs report and check it
+    // once per pass, the others at every example.
     template<class T>    
     int trainFile(const T& a, const char* filename, 
-		  const int iter = 10,  const bool verb = true, const bool shuffle = true);
+		  const int iter = 10,  const bool verb = true, const bool shuffle = true,
+		  const int threadN = 1, const parallelMethod pm = HOGWILD,
+		  trainControl* ctl = NULL);
+    int trainFile(const trainMethod tm, const char* filename,
+		  const int iter = 10,  const bool verb = true, const bool shuffle = true,
+		  const int threadN = 1, const parallelMethod pm = HOGWILD,
+		  trainControl* ctl = NULL);
+
+    // Trains iter passes over rows in order, ys[i] is the label of row i
+    template<class T, class R>
+    int trainRows(const T& a, const R& rows, const int* ys, const int iter = 1, trainControl* ctl = NULL);
+    template<class R>
+    int trainRows(const trainMethod tm, const R& rows, const int* ys, const int iter = 1, trainControl* ctl = NULL);
 
     int testFile(const char* filename, std::vector<int>& confMat, const bool verb = false);
+    // confMat as in testFile, for rows scored in memory
+    template<class R>
+    void testRows(const R& rows, const int* ys, std::vector<int>& confMat, const int threadN = 1) const;
 
     int parseLine(const std::string& line, fv_t& fv, int& y);
 
     void setC(const float C_);
     void setBias(const float bias_);
 
+    size_t getExampleN() const;
     std::string getErrorLog() const;
     std::string getResultLog() const;
+    bool isTrainable() const; // false after an INFERENCE load or loading an export
+
+    // Learned parameter by its name in save ("w", "b", "w0", "b0", "wa",
+    // "ba", "cov", "covb", "alphas"); n is set to its length. NULL for
+    // unknown or empty ones. Training may reallocate the storage.
+    const float* getParam(const std::string& name, size_t& n) const;
+
+    // Immutable copy of the current model for concurrent scoring. Chunks not
+    // touched since the previous snapshot are shared with it. withCov also
+    // copies what only training needs, for saving the snapshot.
+    std::shared_ptr<const snapshot> makeSnapshot(const bool withCov = false);
+
+    // Saves a snapshot of the model on a thread of its own while the model
+    // may go on training. The file is written as filename.tmp and renamed
+    // to filename once complete, so filename is never seen half written.
+    // The job reports bytes written in its control and a failure in
+    // control().error.
+    trainJob* saveAsync(const char* filename);
     
   private:
+    void touch(const int id){ // mark the chunk of id as changed
+      const size_t c = (size_t)id >> CHUNK_BITS;
+      if (chunkStamps.size() <= c) chunkStamps.resize(c+1, 0);
+      chunkStamps[c] = editStamp;
+    }
+
+    void countUpdate(){
+      if (localUpdateN != NULL) (*localUpdateN)++;
+      else updateN++;
+    }
+
+    int loadLegacy(reader& in);
+    int checkpoint(const char* filename, const uint32_t base);
+    int saveSections(writer& out, uint32_t& id, const uint32_t base);
+    int loadSections(reader& in, const loadMode mode, uint32_t& id);
+    void swapParams(oll& o); // the learned state, not stamps nor logs
+    void markCheckpoint(const uint32_t id);
+    // the weights and bias weight classify reads, in avg for AP; NULL for
+    // PAK, which is not linear
+    const fvec* linearWeights(fvec& avg, float& bias_) const;
+    void changedChunks(const size_t n, std::vector<size_t>& chunks) const;
+    template<class T>
+    int sectionRead(std::vector<T>& v, const uint64_t n, const uint64_t size, reader& in);
+
+    int cancelled(){
+      errorLog << "cancelled";
+      return -1;
+    }
+
+    int inferenceOnly(){
+      errorLog << "model loaded for inference only, load it again to train";
+      return -1;
+    }
+
+    template<class T>
+    void trainHogwild(const T& a, const std::vector<std::pair<fv_t, int> >& examples, const int threadN, trainControl* ctl);
+    void reserve(const std::vector<std::pair<fv_t, int> >& examples, const bool withCov);
+
+    template<class T>
+    void trainMix(const T& a, const std::vector<std::pair<fv_t, int> >& examples, const int shardN);
+    void copyParams(const oll& o);
+    void mixParams(const std::vector<std::shared_ptr<oll> >& replicas);
+
     void update(fvec& v, const fv_t& fv, const float alpha);
+    void update(fvec& v, fvec& rest, const fv_t& fv, const double alpha);
     void updateCW(const fv_t& fv, const int y, const float alpha);
     void updatePAK(const fv_t& fv, const float alpha);
 
+    void classifyBlock(const fv_t* fvs, const size_t n, float* scores, fvec& buf) const;
+    void classifyBlockK(const fv_t* fvs, const size_t n, float* scores, fvec& margin) const;
+
     void project(fvec& v);
     float inp(const fv_t& fv1, const fv_t& fv2) const;
 
     template<class T>
-    int valWrite(const T& v, FILE* fp, const char* name);
+    int valWrite(const T& v, writer& out, const char* name);
 
+    // Vectors are stored as their length followed by the elements in one
+    // block; inv_svs as its length and then each posting list that way.
     template<class T>
-    int vecWrite(const std::vector<T>& v, FILE* fp, const char* name);
+    int vecWrite(const std::vector<T>& v, writer& out, const char* name);
+    int vecWrite(const std::vector<fv_t>& v, writer& out, const char* name);
 
     template<class T>
-    int valRead(T& v, FILE* fp, const char* name);
+    int valRead(T& v, reader& in, const char* name);
 
     template<class T>
-    int vecRead(std::vector<T>& v, FILE* fp, const char* name);
+    int vecRead(std::vector<T>& v, reader& in, const char* name);
+    int vecRead(std::vector<fv_t>& v, reader& in, const char* name);
 
     size_t exampleN;
     size_t featureN;
     size_t updateN;
+    static thread_local size_t* localUpdateN; // trainHogwild workers count their updates apart
 
     float C;
     float bias;
@@ -125,25 +529,175 @@ namespace oll_tool{
     float b0;
 
     fvec wa; 
+    fvec waRest; // wa + waRest is the sum in double precision; not saved
     float ba;
 
     // kernelized passive agressive
     fvec alphas;
     std::vector<fv_t> inv_svs; // Inverted File Index for Support Vectors
-    fvec margins; // used for getMarginK
 
     // Confidence Weighted
     fvec cov; 
     float covb; 
 
+    bool trainable; // false when load left out sections
+
+    // Snapshots
+    std::vector<size_t> chunkStamps; // editStamp of the last change per chunk
+    size_t editStamp;
+    size_t snapshotStamp; // editStamp when lastSnapshot was made
+    std::shared_ptr<const snapshot> lastSnapshot;
+
+    // Delta checkpoints
+    size_t checkpointStamp;  // editStamp when the base was written or read
+    uint32_t checkpointId;   // header checksum of the base, 0: none
+    size_t checkpointAlphaN; // alphas.size() then
+    size_t checkpointExampleN;
+
     std::ostringstream errorLog;
     std::ostringstream resultLog;
   };
 
+  // Model version made by oll::makeSnapshot. Its state is never modified,
+  // so any number of threads can score with it while training goes on.
+  class snapshot{
+    friend class oll;
+  public:
+    float classify(const fv_t& fv) const;
+    float classify(const fv_t& fv, fvec& buf) const; // buf: scratch for PAK
+    size_t getExampleN() const;
+
+  private:
+    template<class T>
+    struct chunks{
+      typedef std::vector<std::shared_ptr<const std::vector<T> > > chunks_t;
+      chunks_t c;
+      size_t n;
+
+      chunks() : n(0) {}
+      const T& operator[](const size_t i) const { return (*c[i >> CHUNK_BITS])[i & (CHUNK_SIZE-1)]; }
+      size_t size() const { return n; }
+    };
+
+    template<class T>
+    static void share(const std::vector<T>& v, const chunks<T>* prev, chunks<T>& next,
+		      const std::vector<size_t>& stamps, const size_t since);
+
+    float getMargin(const chunks<float>& v, const float bias_, const fv_t& fv) const;
+    float getMarginK(const fv_t& fv, fvec& margins) const;
+
+    int save(writer& out, trainControl* ctl, std::ostream& errorLog) const; // as oll::save
+    int saveFile(const std::string& filename, trainControl& ctl) const;      // through filename.tmp
+
+    size_t exampleN;
+    size_t featureN;
+    size_t updateN;
+    float C;
+    float bias;
+    chunks<float> w;
+    float b;
+    chunks<float> w0;
+    float b0;
+    chunks<float> wa;
+    float ba;
+    chunks<float> alphas;
+    chunks<fv_t> inv_svs;
+    chunks<float> cov; // empty unless made withCov
+    float covb;
+  };
+
+  // Read-only model over a file written by oll::save, scored in place:
+  // open maps the file instead of reading it, so that opening costs the
+  // same for any model size and forked processes share the pages.
+  // Any number of threads can classify at once.
+  class mappedModel{
+  public:
+    mappedModel();
+    ~mappedModel();
+
+    int open(const char* filename);
+    // buf (8-byte aligned) holds a saved model and must outlive this
+    int attach(const char* buf, const size_t size);
+    void close();
+    // open checks the header only; verify reads every section against
+    // its checksum
+    int verify();
+
+    float classify(const fv_t& fv) const;
+    float classify(const fv_t& fv, fvec& buf) const; // buf: scratch for PAK
+    template<class R>
+    void classifyRows(const R& rows, float* scores, const int threadN = 1) const; // scores: rows.size()
+
+    size_t getExampleN() const;
+    std::string getErrorLog() const;
+
+  private:
+    mappedModel(const mappedModel&);
+    mappedModel& operator=(const mappedModel&);
+
+    struct vec{
+      const float* p;
+      const std::pair<int, float>* sparse; // instead of p for a sparse section
+      size_t sparseN;
+      float fill;
+      const uint16_t* half; // instead of p for FLOAT16
+      const uint16_t* bf16; // instead of p for BFLOAT16
+      const int8_t* q;      // instead of p for INT8, weight i times scales[i/64]
+      const float* scales;
+      size_t n;
+      vec() : p(NULL), sparse(NULL), sparseN(0), fill(0.f), half(NULL), bf16(NULL), q(NULL), scales(NULL), n(0) {}
+    };
+
+    int parse(const char* buf, const size_t size);
+    float getMargin(const vec& v, const float bias_, const fv_t& fv) const;
+    float getMarginK(const fv_t& fv, fvec& margins) const;
+
+    void* map;       // the mapping made by open
+    size_t mapSize;
+    std::vector<char> copy; // the file, where it cannot be mapped
+    const char* data;       // the model, in map, copy or attached
+
+    size_t exampleN;
+    vec w;
+    float b;
+    vec w0;
+    float b0;
+    vec wa;
+    float ba;
+    vec alphas;
+    const uint64_t* svptr; // posting list of id: svs[svptr[id], svptr[id+1])
+    size_t svptrN;
+    const std::pair<int, float>* svs;
+    size_t svsN;
+
+    std::ostringstream errorLog;
+  };
+
+  // Combines models of one algorithm saved by oll::save, such as models
+  // trained on separate shards, into one model file. w and the bias weight
+  // are averaged with the weights of add; for AP, wa is rescaled as MIX
+  // training does so that the averaged perceptrons are averaged; for CW,
+  // w and b are weighted by precision (1/cov) and the precisions averaged.
+  // exampleN and updateN add up. merge reads the inputs side by side, a
+  // chunk of each vector at a time, so memory does not grow with them.
+  class modelMerger{
+  public:
+    // weight < 0: the model's exampleN (equal weights when all are 0)
+    void add(const char* filename, const float weight = -1.f);
+    int merge(const char* filename);
+    std::string getErrorLog() const;
+
+  private:
+    std::vector<std::pair<std::string, float> > inputs;
+    std::ostringstream errorLog;
+  };
+
   // Templates
 
   template<class T>
-  int oll::trainFile(const T& a, const char* filename, const int iter, const bool verb, const bool shuffle){
+  int oll::trainFile(const T& a, const char* filename, const int iter, const bool verb, const bool shuffle,
+		     const int threadN, const parallelMethod pm, trainControl* ctl){
+    if (!trainable) return inferenceOnly();
     std::ifstream ifs(filename);
     if (!ifs){
       errorLog << "cannot open " << filename;
@@ -156,6 +710,7 @@ namespace oll_tool{
     while (getline(ifs, line)){
       lineN++;
       if (line[0] == '#') continue; // comment   
+      if (ctl && ctl->cancel) return cancelled();
 
       fv_t fv;
       int  y = 0;
@@ -166,6 +721,7 @@ namespace oll_tool{
 
       if (iter == 0){ // on the fly
 	trainExample(a, fv, y);
+	if (ctl) ctl->done++;
       } else {
 	examples.push_back(std::make_pair(fv, y));
       }
@@ -176,10 +732,26 @@ namespace oll_tool{
       std::random_shuffle(examples.begin(), examples.end());
     }
 
+    const bool hogwild = threadN > 1 && pm == HOGWILD && hogwild_s<T>::ok;
+    const bool mix     = threadN > 1 && pm == MIX && !std::is_same<T, PAK_s>::value;
+    if (hogwild) reserve(examples, std::is_same<T, CW_s>::value);
+    if (ctl) ctl->total = examples.size() * (iter > 0 ? iter : 0);
+
     for (int i = 0; i < iter; i++){
-      for (size_t j = 0; j < examples.size(); j++){
-     	trainExample(a, examples[j].first, examples[j].second);
+      if (ctl && ctl->cancel) return cancelled();
+      if (hogwild){
+	trainHogwild(a, examples, threadN, ctl);
+	if (ctl && ctl->cancel) return cancelled();
+      } else if (mix){
+	trainMix(a, examples, threadN);
+      } else {
+	for (size_t j = 0; j < examples.size(); j++){
+	  if (ctl && ctl->cancel) return cancelled();
+	  trainExample(a, examples[j].first, examples[j].second);
+	  if (ctl) ctl->done++;
+	}
       }
+      if (ctl && mix) ctl->done += examples.size();
       if (verb) {
 	std::cout << ".";
 	if ((iter+1) % 50 == 0) std::cout << std::endl;
@@ -190,9 +762,188 @@ namespace oll_tool{
   }
 
 
+  // One epoch, each thread trains a contiguous part of examples. w is sized
+  // beforehand by reserve, so the racy updates never reallocate it. The
+  // racy increments of exampleN and updateN are replaced by the counts of
+  // the threads once they are done.
+  template<class T>
+  void oll::trainHogwild(const T& a, const std::vector<std::pair<fv_t, int> >& examples, const int threadN, trainControl* ctl){
+    const size_t n = examples.size();
+    const size_t prevExampleN = exampleN;
+    std::vector<size_t> exampleNs(threadN, 0), updateNs(threadN, 0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadN; t++){
+      threads.push_back(std::thread([&, t](){
+	size_t trained = 0, updates = 0;
+	localUpdateN = &updates;
+	for (size_t j = n * t / threadN; j < n * (t+1) / threadN; j++){
+	  if (ctl && ctl->cancel) break;
+	  trainExample(a, examples[j].first, examples[j].second);
+	  trained++;
+	}
+	localUpdateN = NULL;
+	exampleNs[t] = trained;
+	updateNs[t]  = updates;
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); t++){
+      threads[t].join();
+    }
+    size_t trained = 0;
+    for (int t = 0; t < threadN; t++){
+      trained += exampleNs[t];
+      updateN += updateNs[t];
+    }
+    if (exampleN != prevExampleN) exampleN = prevExampleN + trained; // CW does not count them
+    if (ctl) ctl->done += trained;
+  }
+
+  // One epoch of iterative parameter mixing: every shard is trained by its
+  // own replica starting from the current parameters, then the replicas
+  // are averaged back into this model.
   template<class T>
-  int oll::valWrite(const T& v, FILE* fp, const char* name){
-    if (fwrite(&v, sizeof(T), 1, fp) != 1){ 
+  void oll::trainMix(const T& a, const std::vector<std::pair<fv_t, int> >& examples, const int shardN){
+    const size_t n = examples.size();
+    std::vector<std::shared_ptr<oll> > replicas(shardN);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < shardN; t++){
+      replicas[t].reset(new oll);
+      replicas[t]->copyParams(*this);
+      threads.push_back(std::thread([&, t](){
+	for (size_t j = n * t / shardN; j < n * (t+1) / shardN; j++){
+	  replicas[t]->trainExample(a, examples[j].first, examples[j].second);
+	}
+      }));
+    }
+    for (size_t t = 0; t < threads.size(); t++){
+      threads[t].join();
+    }
+    mixParams(replicas);
+  }
+
+  template<class T, class R>
+  int oll::trainRows(const T& a, const R& rows, const int* ys, const int iter, trainControl* ctl){
+    if (!trainable) return inferenceOnly();
+    if (ctl) ctl->total = rows.size() * (iter > 0 ? iter : 0);
+    fv_t fv;
+    for (int i = 0; i < iter; i++){
+      for (size_t j = 0; j < rows.size(); j++){
+	if (ctl && ctl->cancel) return cancelled();
+	rows.get(j, fv);
+	trainExample(a, fv, ys[j]);
+	if (ctl) ctl->done++;
+      }
+    }
+    return 0;
+  }
+
+  template<class R>
+  int oll::trainRows(const trainMethod tm, const R& rows, const int* ys, const int iter, trainControl* ctl){
+    if (tm == P){
+      return trainRows(P_s(), rows, ys, iter, ctl);
+    } else if (tm == AP){
+      return trainRows(AP_s(), rows, ys, iter, ctl);
+    } else if (tm == PA){
+      return trainRows(PA_s(), rows, ys, iter, ctl);
+    } else if (tm == PA1){
+      return trainRows(PA1_s(), rows, ys, iter, ctl);
+    } else if (tm == PA2){
+      return trainRows(PA2_s(), rows, ys, iter, ctl);
+    } else if (tm == PAK){
+      return trainRows(PAK_s(), rows, ys, iter, ctl);
+    } else if (tm == CW){
+      return trainRows(CW_s(), rows, ys, iter, ctl);
+    } else if (tm == AL){
+      return trainRows(AL_s(), rows, ys, iter, ctl);
+    }
+    errorLog << "unknown trainMethod " << tm;
+    return -1;
+  }
+
+  template<class R>
+  void dataset::append(const R& rows, const int* ys_){
+    fv_t fv;
+    for (size_t i = 0; i < rows.size(); i++){
+      rows.get(i, fv);
+      for (size_t j = 0; j < fv.size(); j++){
+	indices.push_back(fv[j].first);
+	data.push_back(fv[j].second);
+      }
+      indptr.push_back(indices.size());
+      ys.push_back(ys_[i]);
+    }
+  }
+
+  template<class R>
+  void oll::testRows(const R& rows, const int* ys, std::vector<int>& confMat, const int threadN) const {
+    fvec scores(rows.size());
+    if (rows.size() > 0) classifyRows(rows, &scores[0], threadN);
+    confMat.assign(4, 0); // pp, pn, np, nn
+    for (size_t i = 0; i < scores.size(); i++){
+      confMat[(ys[i] == 1 ? 0 : 2) + (scores[i] >= 0 ? 0 : 1)]++;
+    }
+  }
+
+  template<class R>
+  void oll::classifyRows(const R& rows, float* scores, const int threadN) const {
+    forBlocks(rows.size(), threadN, [&](const size_t begin, const size_t n, fvec& buf){
+	thread_local std::vector<fv_t> block;
+	block.resize(BATCH_BLOCK);
+	for (size_t i = 0; i < n; i++){
+	  rows.get(begin + i, block[i]);
+	}
+	classifyBlock(&block[0], n, scores + begin, buf);
+      });
+  }
+
+  template<class R>
+  void mappedModel::classifyRows(const R& rows, float* scores, const int threadN) const {
+    forBlocks(rows.size(), threadN, [&](const size_t begin, const size_t n, fvec& buf){
+	thread_local fv_t fv;
+	for (size_t i = 0; i < n; i++){
+	  rows.get(begin + i, fv);
+	  scores[begin + i] = classify(fv, buf);
+	}
+      });
+  }
+
+  template<class F>
+  void forBlocks(const size_t n, const int threadN, F f){
+    if (n == 0) return;
+    const size_t blockN = (n + BATCH_BLOCK - 1) / BATCH_BLOCK;
+    std::atomic<size_t> next(0);
+    auto worker = [&](){
+      fvec buf; // margins tile, kept across blocks
+      for (size_t blk = next++; blk < blockN; blk = next++){
+	const size_t begin = blk * BATCH_BLOCK;
+	f(begin, std::min(BATCH_BLOCK, n - begin), buf);
+      }
+    };
+
+    const size_t threadNum = std::min(blockN, (size_t)std::max(threadN, 1));
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadNum; i++){
+      threads.push_back(std::thread(worker));
+    }
+    worker();
+    for (size_t i = 0; i < threads.size(); i++){
+      threads[i].join();
+    }
+  }
+
+  // reads a dense section of n elements in size bytes
+  template<class T>
+  int oll::sectionRead(std::vector<T>& v, const uint64_t n, const uint64_t size, reader& in){
+    if (size / sizeof(T) != n || size % sizeof(T) != 0 || n > in.left() / sizeof(T)) return -1;
+    v.clear();
+    v.resize(n);
+    if (n > 0 && !in.read(&v[0], size)) return -1;
+    return 0;
+  }
+
+  template<class T>
+  int oll::valWrite(const T& v, writer& out, const char* name){
+    if (!out.write(&v, sizeof(T))){ 
      errorLog << "fwrite error " << name;
       return -1;
     }
@@ -200,19 +951,21 @@ namespace oll_tool{
   }
 
   template<class T>
-  int oll::vecWrite(const std::vector<T>& v, FILE* fp, const char* name){
+  int oll::vecWrite(const std::vector<T>& v, writer& out, const char* name){
+    static_assert(std::is_trivially_copyable<T>::value || std::is_same<T, std::pair<int, float> >::value,
+		  "vecWrite writes the bytes of the elements");
     size_t n = v.size();
-    if (valWrite(n, fp, name) == -1) return -1;
-    for (size_t i = 0; i < v.size(); i++){
-      T val = v[i];
-      if (valWrite(val, fp, name) == -1) return -1;
+    if (valWrite(n, out, name) == -1) return -1;
+    if (n > 0 && !out.write(&v[0], n * sizeof(T))){
+      errorLog << "fwrite error " << name;
+      return -1;
     }
     return 0;
   }
 
   template<class T>
-  int oll::valRead(T& v, FILE* fp, const char* name){
-    if (fread(&v, sizeof(T), 1, fp) != 1){
+  int oll::valRead(T& v, reader& in, const char* name){
+    if (!in.read(&v, sizeof(T))){
       errorLog << "fread error " << name;
       return -1;
     }
@@ -221,17 +974,20 @@ namespace oll_tool{
 
 
   template<class T>
-  int oll::vecRead(std::vector<T>& v, FILE* fp, const char* name){
+  int oll::vecRead(std::vector<T>& v, reader& in, const char* name){
+    static_assert(std::is_trivially_copyable<T>::value || std::is_same<T, std::pair<int, float> >::value,
+		  "vecRead reads the bytes of the elements");
     size_t n = 0;
-    if (valRead(n, fp, name) == -1) return -1;
+    if (valRead(n, in, name) == -1) return -1;
+    if (n > in.left() / sizeof(T)){
+      errorLog << "fread error " << name;
+      return -1;
+    }
     v.clear();
     v.resize(n);
-
-    // Is fread((void*)v.begin(), sizeof(T), n, fp) possible ?
-    for (size_t i = 0; i < n; i++){
-      T val;
-      if (valRead(val, fp, name) == -1) return -1;
-      v[i] = val;
+    if (n > 0 && !in.read(&v[0], n * sizeof(T))){
+      errorLog << "fread error " << name;
+      return -1;
     }
     return 0;
   }
@@ -0,0 +1,165 @@
+// extern "C" interface of oll_c.h over oll_tool::oll
+
+#include <new>
+#include <cmath> // NAN
+#include <algorithm>
+#include <string>
+#include <stdexcept>
+#include "oll.hpp"
+#include "oll_c.h"
+
+struct oll_model{
+  oll_tool::oll ol;
+  oll_tool::trainMethod tm;
+  size_t logged; // length of ol's error log already reported
+};
+
+namespace {
+  thread_local std::string lastError;
+
+  int fail(const std::string& message){
+    lastError = message;
+    return -1;
+  }
+
+  // only the text m logged in the failed call, the error log of oll
+  // keeps every message
+  int fail(oll_model* m){
+    const std::string log = m->ol.getErrorLog();
+    const size_t logged = std::min(m->logged, log.size());
+    m->logged = log.size();
+    return fail(log.substr(logged));
+  }
+
+  // no exception may cross the C interface
+  template<class F>
+  int guard(F f){
+    try {
+      return f();
+    } catch (const std::exception& e){
+      return fail(e.what());
+    }
+  }
+
+  // per-thread copy of the caller's arrays in the form oll takes. The
+  // one-row csrRows path copies as well (rows.get), into a vector made
+  // per call, so this buffer is kept.
+  const oll_tool::fv_t& toFeatureVector(const int* ids, const float* values, const size_t n){
+    thread_local oll_tool::fv_t fv;
+    fv.resize(n);
+    for (size_t i = 0; i < n; i++){
+      fv[i] = std::make_pair(ids[i], values[i]);
+    }
+    return fv;
+  }
+
+  bool checkCSR(const int* indptr, const int* indices, const size_t rows){
+    if (indptr[0] < 0) return false;
+    for (size_t i = 0; i < rows; i++){
+      if (indptr[i+1] < indptr[i]) return false;
+    }
+    for (int k = indptr[0]; k < indptr[rows]; k++){
+      if (indices[k] < 0) return false;
+    }
+    return true;
+  }
+
+  bool checkLabels(const int* ys, const size_t n){
+    for (size_t i = 0; i < n; i++){
+      if (ys[i] != 1 && ys[i] != -1) return false;
+    }
+    return true;
+  }
+}
+
+extern "C" {
+
+oll_model* oll_create(int method, float C, float bias){
+  if (method < OLL_P || method > OLL_AL){
+    fail("unknown method");
+    return NULL;
+  }
+  oll_model* m = new (std::nothrow) oll_model;
+  if (m == NULL){
+    fail("out of memory");
+    return NULL;
+  }
+  m->tm = static_cast<oll_tool::trainMethod>(method);
+  m->logged = 0;
+  m->ol.setC(C);
+  m->ol.setBias(bias);
+  return m;
+}
+
+void oll_free(oll_model* m){
+  delete m;
+}
+
+const char* oll_error(void){
+  return lastError.c_str();
+}
+
+int oll_train(oll_model* m, const int* ids, const float* values, size_t n, int y){
+  if (y != 1 && y != -1) return fail("y is not +1 nor -1");
+  for (size_t i = 0; i < n; i++){
+    if (ids[i] < 0) return fail("negative feature id");
+  }
+  return guard([&](){
+      if (m->ol.trainExample(m->tm, toFeatureVector(ids, values, n), y) == -1) return fail(m);
+      return 0;
+    });
+}
+
+int oll_train_csr(oll_model* m, const int* indptr, const int* indices, const float* data,
+		  size_t rows, const int* ys, int iter){
+  if (!checkCSR(indptr, indices, rows)) return fail("malformed CSR arrays");
+  if (!checkLabels(ys, rows)) return fail("y is not +1 nor -1");
+  return guard([&](){
+      const oll_tool::csrRows<int, float> r(indptr, indices, data, rows);
+      if (m->ol.trainRows(m->tm, r, ys, iter) == -1) return fail(m);
+      return 0;
+    });
+}
+
+float oll_classify(const oll_model* m, const int* ids, const float* values, size_t n){
+  float score = NAN;
+  guard([&](){
+      score = m->ol.classify(toFeatureVector(ids, values, n));
+      return 0;
+    });
+  return score;
+}
+
+int oll_classify_csr(const oll_model* m, const int* indptr, const int* indices, const float* data,
+		     size_t rows, float* scores, int threads){
+  if (!checkCSR(indptr, indices, rows)) return fail("malformed CSR arrays");
+  return guard([&](){
+      m->ol.classifyRows(oll_tool::csrRows<int, float>(indptr, indices, data, rows), scores, threads);
+      return 0;
+    });
+}
+
+size_t oll_save_size(oll_model* m){
+  size_t size = 0;
+  guard([&](){
+      size = m->ol.saveSize();
+      return 0;
+    });
+  return size;
+}
+
+int oll_save(oll_model* m, char* buf, size_t size){
+  return guard([&](){
+      if (m->ol.save(buf, size) == -1) return fail(m);
+      return 0;
+    });
+}
+
+int oll_load(oll_model* m, const char* buf, size_t size){
+  return guard([&](){
+      if (m->ol.load(buf, size) == -1) return fail(m);
+      return 0;
+    });
+}
+
+}
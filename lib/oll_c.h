@@ -0,0 +1,73 @@
+#ifndef OLL_C_H__
+#define OLL_C_H__
+
+/* C interface of oll, for programs that cannot use oll.hpp
+ *
+ * g++ -O2 -shared -fPIC -Ilib lib/oll_c.cpp lib/oll.cpp -o liboll.so -pthread
+ *
+ * A model is an opaque handle made by oll_create and released by oll_free.
+ * Examples are passed as arrays of feature ids and values which are read
+ * during the call and never kept. They are not used in place: the library
+ * works on (id, value) pairs, into which each example (each row for the
+ * CSR functions) is copied, in a per-thread buffer reused across calls.
+ * Functions returning int give 0 on success and -1 on failure, and
+ * oll_error tells why.
+ *
+ * The oll_classify functions only read the model: any number of threads
+ * may call them at once, as long as no thread trains or loads the model.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct oll_model oll_model;
+
+/* same values as oll_tool::trainMethod */
+enum oll_method {
+  OLL_P   = 0, /* Perceptron */
+  OLL_AP  = 1, /* Averaged Perceptron */
+  OLL_PA  = 2, /* Passive Agressive */
+  OLL_PA1 = 3, /* Passive Agressive I */
+  OLL_PA2 = 4, /* Passive Agressive II */
+  OLL_PAK = 5, /* Kernelized Passive Agressive */
+  OLL_CW  = 6, /* Confidence Weighted */
+  OLL_AL  = 7  /* ALMA HD */
+};
+
+/* NULL for an unknown method or when out of memory */
+oll_model* oll_create(int method, float C, float bias);
+void oll_free(oll_model* m);
+
+/* message of the last failure in the calling thread */
+const char* oll_error(void);
+
+/* one example of n features, y is 1 or -1 */
+int oll_train(oll_model* m, const int* ids, const float* values, size_t n, int y);
+
+/* iter passes over the rows of a CSR matrix: row i has the features
+   indices/data[indptr[i], indptr[i+1]) and the label ys[i] */
+int oll_train_csr(oll_model* m, const int* indptr, const int* indices, const float* data,
+                  size_t rows, const int* ys, int iter);
+
+/* NaN on failure */
+float oll_classify(const oll_model* m, const int* ids, const float* values, size_t n);
+
+/* scores[i] is the score of row i; threads > 1 scores blocks of rows
+   in parallel */
+int oll_classify_csr(const oll_model* m, const int* indptr, const int* indices, const float* data,
+                     size_t rows, float* scores, int threads);
+
+/* The model in the format of oll::save. oll_save_size gives the size
+   of the buffer oll_save fills, or 0 on failure. */
+size_t oll_save_size(oll_model* m);
+int oll_save(oll_model* m, char* buf, size_t size);
+int oll_load(oll_model* m, const char* buf, size_t size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* OLL_C_H__ */
@@ -1,5 +1,7 @@
-from .oll import oll
+from .oll import (oll, Dataset, MappedModel, merge, TRAINING, INFERENCE,
+                  FLOAT32, FLOAT16, INT8, BFLOAT16, HOGWILD, MIX)
 
 VERSION = (0, 2, 1)
 __version__ = "0.2.1"
-__all__ = ["oll"]
+__all__ = ["oll", "Dataset", "MappedModel", "merge", "TRAINING", "INFERENCE",
+           "FLOAT32", "FLOAT16", "INT8", "BFLOAT16", "HOGWILD", "MIX"]
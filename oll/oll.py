@@ -3,7 +3,21 @@
 #
 # Do not make changes to this file unless you know what you are doing--modify
 # the SWIG interface file instead.
-import functools
+import weakref
+
+try:
+    from concurrent.futures import CancelledError, TimeoutError
+except ImportError:  # Python 2 without the futures backport
+    class CancelledError(Exception):
+        pass
+
+    class TimeoutError(Exception):
+        pass
+
+try:
+    import numpy as np
+except ImportError:  # only needed by fit/predict on numpy/scipy input
+    np = None
 
 from sys import version_info
 if version_info >= (2, 6, 0):
@@ -209,6 +223,14 @@ PA2 = _oll.PA2
 PAK = _oll.PAK
 CW = _oll.CW
 AL = _oll.AL
+HOGWILD = _oll.HOGWILD
+MIX = _oll.MIX
+TRAINING = _oll.TRAINING
+INFERENCE = _oll.INFERENCE
+FLOAT32 = _oll.FLOAT32
+FLOAT16 = _oll.FLOAT16
+INT8 = _oll.INT8
+BFLOAT16 = _oll.BFLOAT16
 
 
 class P_s(_object):
@@ -371,6 +393,291 @@ AL_s_swigregister = _oll.AL_s_swigregister
 AL_s_swigregister(AL_s)
 
 
+def _matrix_buffers(X):
+    """
+    Return the buffers handed to the native row sources: (indptr,
+    indices, data) of a CSR matrix or a 2-d float array. X is not
+    copied when its index and value types are already supported.
+    """
+    def floats(a):
+        if a.dtype.type in (np.float32, np.float64) and a.dtype.isnative:
+            return a
+        return a.astype(np.float64)
+
+    if hasattr(X, 'tocsr'):  # for sparse matrix
+        X = X.tocsr()
+        (indptr, indices) = (X.indptr, X.indices)
+        if (indices.dtype.type not in (np.int32, np.int64) or
+                indptr.dtype != indices.dtype):
+            (indptr, indices) = (indptr.astype(np.int64),
+                                 indices.astype(np.int64))
+        return (indptr, indices, floats(X.data))
+    return (floats(np.asarray(X)),)
+
+
+def _labels(y):
+    y = np.ascontiguousarray(y, dtype=np.int32)
+    assert np.all((y == 1) | (y == -1))
+    return y
+
+
+def _confusion_matrix(conf_mat_vec):
+    correct = conf_mat_vec[0] + conf_mat_vec[3]
+    total = sum(conf_mat_vec)
+    return {
+        'accuracy': correct * 100 / total,
+        'true-positive': conf_mat_vec[0],
+        'false-negative': conf_mat_vec[1],
+        'false-positive': conf_mat_vec[2],
+        'true-negative': conf_mat_vec[3]
+    }
+
+
+class Dataset(object):
+    """
+    Labeled examples parsed or converted once and kept by the C++ library,
+    to be trained on, scored and evaluated many times (fit, partial_fit,
+    decision_function, predict, evaluate) without a file or a conversion
+    per call.
+
+    >>> data = Dataset('train.svm')
+    >>> data = Dataset(X, y)
+    >>> fold = data[np.arange(0, len(data), 2)]
+
+    Indexing with an index array, a boolean mask or a slice returns a
+    Dataset over the same examples; only the row indices are stored.
+    """
+
+    def __init__(self, X, y=None):
+        """
+        Args:
+            X : <str> libsvm file, numpy.ndarray or scipy.sparse matrix,
+                shape = (n_samples, n_features)
+            y : labels (1 or -1) of the rows of a matrix
+        """
+        self._store = _oll.new_dataset()
+        self._index = None
+        if isinstance(X, str):
+            _oll.dataset_readFile(self._store, X)
+            return
+        if y is None:
+            raise ValueError('y is needed for a matrix')
+        y = _labels(y)
+        buffers = _matrix_buffers(X)
+        if len(buffers) == 3:
+            _oll.dataset_appendCSR(self._store, *(buffers + (y,)))
+        else:
+            _oll.dataset_appendDense(self._store, buffers[0], y)
+
+    def __len__(self):
+        if self._index is None:
+            return _oll.dataset_size(self._store)
+        return len(self._index)
+
+    def __getitem__(self, key):
+        n = len(self)
+        if isinstance(key, slice):
+            index = np.arange(*key.indices(n), dtype=np.intp)
+        else:
+            key = np.asarray(key)
+            if key.dtype == bool:
+                if key.shape != (n,):
+                    raise IndexError('boolean mask does not match the rows')
+                index = np.flatnonzero(key).astype(np.intp)
+            else:
+                index = key.astype(np.intp).reshape(-1)
+                index = np.where(index < 0, index + n, index)
+                if len(index) and (index.min() < 0 or index.max() >= n):
+                    raise IndexError('row index out of range')
+        if self._index is not None:
+            index = self._index[index]
+        subset = Dataset.__new__(Dataset)
+        subset._store = self._store
+        subset._index = np.ascontiguousarray(index)
+        return subset
+
+    @property
+    def labels(self):
+        """
+        Labels of the rows, numpy.ndarray of int32 (1 or -1)
+        """
+        y = np.empty(len(self), dtype=np.int32)
+        _oll.dataset_labels(self._store, self._index, y)
+        return y
+
+
+class TrainingFuture(object):
+    """
+    Training run started by oll.fit_async, in the manner of
+    concurrent.futures.Future. The run goes on in a native thread that
+    never takes the GIL; the model must not be used until it is over.
+    Dropping the future cancels the run.
+    """
+
+    def __init__(self, model, job):
+        self._model = model
+        self._job = job
+
+    def done(self):
+        return _oll.trainJob_wait(self._job, 0.0)
+
+    def running(self):
+        return not self.done()
+
+    def cancel(self):
+        """
+        Stop the run at the next example.
+        The model keeps what was trained so far.
+        Return:
+            <bool> False when the run was already over
+        """
+        if self.done():
+            return False
+        _oll.trainJob_cancel(self._job)
+        return True
+
+    def cancelled(self):
+        return self.done() and _oll.trainJob_result(self._job)[1]
+
+    def progress(self):
+        """
+        Return:
+            <float> share of the examples trained, from 0.0 to 1.0 (0.0
+            while a file is being read)
+        """
+        (done, total) = _oll.trainJob_progress(self._job)
+        return float(done) / total if total else float(self.done())
+
+    def result(self, timeout=None):
+        """
+        Wait for the run and return the model.
+        Args:
+            <float> timeout: seconds, None for no limit
+        """
+        if not _oll.trainJob_wait(self._job,
+                                  -1.0 if timeout is None else timeout):
+            raise TimeoutError()
+        (ret, cancelled, log) = _oll.trainJob_result(self._job)
+        if cancelled:
+            raise CancelledError()
+        if ret == -1:
+            raise RuntimeError(log)
+        return self._model
+
+    def exception(self, timeout=None):
+        try:
+            self.result(timeout)
+        except (CancelledError, TimeoutError):
+            raise
+        except RuntimeError as e:
+            return e
+        return None
+
+
+class SaveFuture(TrainingFuture):
+    """
+    Save started by oll.save_async. The model may be trained and used
+    meanwhile: what is written is the model as it was at the call.
+    progress() is the share of the bytes written, and cancel() stops the
+    writing, leaving the file as it was. Dropping the future does not: the
+    file is still written.
+    """
+
+
+class MappedModel(object):
+    """
+    Read-only model over a file written by oll.save, scored in place from a
+    memory mapping of the file: opening costs the same for any model size,
+    and processes mapping the same file share its pages.
+
+    >>> model = MappedModel('oll.model')
+    >>> model.predict(X)
+    """
+
+    def __init__(self, filename):
+        """
+        Arg:
+            <str> filename: model saved by oll.save (a model in the older
+            format has to be loaded and saved again)
+        """
+        self._model = _oll.new_mappedModel(filename)
+
+    @property
+    def example_count(self):
+        return _oll.mappedModel_getExampleN(self._model)
+
+    def verify(self):
+        """
+        Check every section against its checksum (opening checks the
+        header only).
+
+        Return:
+            0, or -1 when the file is corrupt
+        """
+        return _oll.mappedModel_verify(self._model)
+
+    def classify(self, example):
+        """
+        Arg:
+            <dict <int>, <float>> example: feature vector, or a pair
+            (ids, values), as for oll.classify
+        Return:
+            <float> result
+        """
+        return _oll.mappedModel_classifyExample(self._model, example)
+
+    def decision_function(self, X, n_jobs=1):
+        """
+        Args
+        X : numpy.ndarray or scipy.sparse matrix,
+            shape = (n_samples, self.n_features)
+        n_jobs : number of scoring threads
+        Return
+        scores : numpy.ndarray of float32, shape = (n_samples,)
+        """
+        buffers = _matrix_buffers(X)
+        scores = np.empty(X.shape[0], dtype=np.float32)
+        if len(buffers) == 3:
+            _oll.mappedModel_classifyCSR(self._model,
+                                         *(buffers + (scores, n_jobs)))
+        else:
+            _oll.mappedModel_classifyDense(self._model, buffers[0], scores,
+                                           n_jobs)
+        return scores
+
+    def predict(self, X, n_jobs=1):
+        """
+        Return
+        labels : numpy.ndarray of int (it takes 1 or -1)
+        """
+        return np.where(self.decision_function(X, n_jobs) > 0, 1, -1)
+
+
+def merge(filenames, filename, weights=None):
+    """
+    Combine models of one algorithm saved by oll.save (one per data shard,
+    say) into the model file filename. w and b are averaged with weights,
+    AP models as their averaged perceptrons and CW models weighted by the
+    precision of each weight; example counts add up. The files are read
+    side by side a chunk at a time, so memory does not grow with them.
+
+    >>> merge(['shard0.model', 'shard1.model'], 'merged.model')
+
+    Args:
+        filenames : sequence of <str>
+        <str> filename
+        weights : sequence of <float>, None for the example counts
+    Raise:
+        IOError when a model cannot be read or merged, or filename written
+    """
+    filenames = list(filenames)
+    if weights is None:
+        weights = [-1.0] * len(filenames)
+    elif len(weights) != len(filenames) or any(w < 0 for w in weights):
+        raise ValueError('one non-negative weight per model is needed')
+    _oll.mergeModels(filenames, [float(w) for w in weights], filename)
+
+
 class oll(_object):
     __swig_setmethods__ = {}
     __setattr__ = lambda self, name, value: _swig_setattr(
@@ -415,23 +722,14 @@ class oll(_object):
             "CW": CW_s,
             "AL": AL_s
         }
-        train_methods = {
-            "P": lambda *args: _oll.oll_trainExampleP(self, *args),
-            "AP": lambda *args: _oll.oll_trainExampleAP(self, *args),
-            "PA": lambda *args: _oll.oll_trainExamplePA(self, *args),
-            "PA1": lambda *args: _oll.oll_trainExamplePA1(self, *args),
-            "PA2": lambda *args: _oll.oll_trainExamplePA2(self, *args),
-            "PAK": lambda *args: _oll.oll_trainExamplePAK(self, *args),
-            "CW": lambda *args: _oll.oll_trainExampleCW(self, *args),
-            "AL": lambda *args: _oll.oll_trainExampleAL(self, *args)
-        }
 
         if algorithm not in algorithms:
             raise ValueError('Unsupported learning algorithm: {0}\n{1}'.format(
                 algorithm, oll.__init__.__doc__))
 
-        self.train_method = functools.partial(train_methods[algorithm],
-                                              algorithms[algorithm.upper()]())
+        self.train_method_id = getattr(_oll, algorithm)
+        self._views = weakref.WeakSet()
+        self._future = None
         self.algorithm = algorithm
         self.setC(C)
         self.C = C
@@ -441,6 +739,88 @@ class oll(_object):
     __swig_destroy__ = _oll.delete_oll
     __del__ = lambda self: None
 
+    def _view(self, name, track=True):
+        """
+        Return a read-only float32 array over the parameter `name` of the
+        C++ model (see oll::getParam), or None when the learner has none.
+        Untracked arrays must not outlive the call that made them.
+        """
+        self._check_idle()
+        view = _oll.oll_getParam(self, name)
+        if view is None:
+            return None
+        if track:
+            self._views.add(view)
+        return np.frombuffer(view, dtype=np.float32)
+
+    def _check_idle(self):
+        """
+        While fit_async trains the model, its thread reallocates the
+        parameters: nothing else may read or write them until it is over.
+        """
+        if self._future is not None and not self._future.done():
+            raise RuntimeError('fit_async is training this model')
+
+    def _check_views(self):
+        """
+        Training and load may reallocate the parameters, which the arrays
+        returned by coef_, intercept_ and cov_ point into.
+        """
+        self._check_idle()
+        if len(self._views):
+            raise BufferError('coef_, intercept_ or cov_ arrays of this model '
+                              'are alive; delete them before training')
+
+    def _check_trainable(self):
+        self._check_views()
+        if not _oll.oll_isTrainable(self):
+            raise RuntimeError('model loaded for inference only, load it '
+                               'again to train')
+
+    @property
+    def coef_(self):
+        """
+        Weights, shape = (1, n_features). Read-only and not copied, except
+        for AP, whose averaged weights are computed. Not available for PAK.
+        """
+        if self.algorithm == 'PAK':
+            raise AttributeError('coef_ is not available for PAK')
+        if self.algorithm == 'AP':
+            (w0, wa) = (self._view('w0', False), self._view('wa', False))
+            if w0 is None:
+                return np.zeros((1, 0), dtype=np.float32)
+            n = np.float32(_oll.oll_getExampleN(self) + 1)
+            return (w0 - wa / n).reshape(1, -1)
+        w = self._view('w')
+        if w is None:
+            return np.zeros((1, 0), dtype=np.float32)
+        return w.reshape(1, -1)
+
+    @property
+    def intercept_(self):
+        """
+        Weight of the bias feature, shape = (1,)
+        """
+        if self.algorithm == 'PAK':
+            raise AttributeError('intercept_ is not available for PAK')
+        if self.algorithm == 'AP':
+            (b0, ba) = (self._view('b0', False), self._view('ba', False))
+            n = np.float32(_oll.oll_getExampleN(self) + 1)
+            return b0 - ba / n
+        return self._view('b')
+
+    @property
+    def cov_(self):
+        """
+        Diagonal covariance of the weights (CW only), shape = (1, n_features)
+        """
+        if self.algorithm != 'CW':
+            raise AttributeError('cov_ is only available for CW')
+        cov = self._view('cov')
+        if cov is None:
+            return np.zeros((1, 0), dtype=np.float32)
+        return cov.reshape(1, -1)
+
     def get_params(self, **kwargs):
         return {'C': self.C, 'bias': self.bias}
 
@@ -454,32 +834,167 @@ class oll(_object):
 
     def save(self, filename):
         """
+        Write the model in the sectioned format, which MappedModel can
+        map. load reads it and the format of the original oll.
+
         Arg:
             <str> filename
         """
+        self._check_idle()
         return _oll.oll_save(self, filename)
 
-    def load(self, filename):
+    def save_async(self, filename):
+        """
+        save from a native thread and return at once
+
+        A snapshot of the model is written to filename + '.tmp', which is
+        renamed to filename once complete. Training may go on meanwhile.
+
+        Arg:
+            <str> filename
+        Return:
+            future : SaveFuture, its result() is this model and raises
+            RuntimeError when the file could not be written
+        """
+        self._check_idle()
+        return SaveFuture(self, _oll.oll_saveAsync(self, filename))
+
+    def load(self, filename, mode=TRAINING):
+        """
+        Args:
+            <str> filename
+            mode: TRAINING, or INFERENCE to leave out what only training
+            needs (the model then cannot be trained)
+        Return:
+            0, or -1 when the file cannot be read or a checksum does not
+            match
+        """
+        self._check_views()
+        return _oll.oll_load(self, filename, mode)
+
+    def checkpoint(self, filename):
         """
+        Save the model as save does and make it the base of save_delta.
+
         Arg:
             <str> filename
         """
-        return _oll.oll_load(self, filename)
+        self._check_idle()
+        return _oll.oll_checkpoint(self, filename)
+
+    def save_delta(self, filename):
+        """
+        Write the parameters changed since the last checkpoint, delta or
+        load; this delta becomes the base of the next one.
+
+        >>> o.checkpoint('base.model')
+        >>> o.fit(X1, y1)
+        >>> o.save_delta('1.delta')
+        >>> replica.load('base.model')
+        >>> replica.load_delta('1.delta')
+
+        Arg:
+            <str> filename
+        """
+        self._check_idle()
+        return _oll.oll_saveDelta(self, filename)
+
+    def load_delta(self, filename):
+        """
+        Replay a delta written by save_delta onto the checkpoint or delta
+        it follows. A delta that cannot be applied leaves the model as it
+        was.
+
+        Arg:
+            <str> filename
+        Return:
+            0, or -1 when the delta is corrupt or follows another state
+        """
+        self._check_views()
+        return _oll.oll_loadDelta(self, filename)
+
+    def compact(self, filename):
+        """
+        Write a model that has just replayed deltas as a checkpoint, to
+        which the deltas still to come apply.
+
+        Arg:
+            <str> filename
+        """
+        self._check_idle()
+        return _oll.oll_compact(self, filename)
+
+    def export(self, filename, precision=FLOAT16):
+        """
+        Write only the weights classify reads, for MappedModel or load
+        (which can then not train). FLOAT16 halves the file of a dense
+        model and INT8 quarters it, at a small cost in score accuracy.
+        BFLOAT16 halves it too, keeping the range of float32 where
+        FLOAT16 clips weights beyond 65504. PAK models cannot be exported.
+
+        Args:
+            <str> filename
+            precision: FLOAT32, FLOAT16, BFLOAT16 or INT8
+        """
+        self._check_idle()
+        return _oll.oll_exportModel(self, filename, precision)
+
+    def export_header(self, filename, name):
+        """
+        Write the weights as a C++ header of constexpr tables in namespace
+        name, with inline score() functions giving decision_function. A
+        program including it needs neither the model file nor this
+        library. PAK models cannot be exported.
+
+        Args:
+            <str> filename
+            <str> name: C++ identifier
+        """
+        self._check_idle()
+        return _oll.oll_exportHeader(self, filename, name)
+
+    def dumps(self):
+        """
+        Return:
+            <bytes> model, as save writes it to a file
+        """
+        self._check_idle()
+        return _oll.oll_dumps(self)
+
+    def loads(self, data, mode=TRAINING):
+        """
+        Args:
+            <bytes> data: model made by dumps or save (any bytes-like
+            object, read in place)
+            mode: as for load
+        """
+        self._check_views()
+        return _oll.oll_loads(self, data, mode)
+
+    def __getstate__(self):
+        return {'algorithm': self.algorithm, 'C': self.C, 'bias': self.bias,
+                'model': self.dumps()}
+
+    def __setstate__(self, state):
+        self.__init__(state['algorithm'], state['C'], state['bias'])
+        if self.loads(state['model']) == -1:
+            raise ValueError('broken model')
 
     def classify(self, example):
         """
         >>> classify({0: 0.5, 20: 0.3})
         0.4
+        >>> classify(([0, 20], [0.5, 0.3]))
+        0.4
 
         Arg:
-            <dict <int>, <float>> example: feature vector
+            <dict <int>, <float>> example: feature vector, or a pair
+            (ids, values) of sequences, array.array or numpy arrays
         Return:
             <float> result
         """
-        fv = FeatureVector()
-        for (_id, value) in example.items():
-            fv.push_back(IntFloatPair(_id, value))
-        return _oll.oll_classify(self, fv)
+        self._check_idle()
+        return _oll.oll_classifyExample(self, example)
 
     def testFile(self, testfile, verb=0):
         """
@@ -489,109 +1004,187 @@ class oll(_object):
         Return:
             <dict <str>, <float>> confusion_matrix
         """
+        self._check_idle()
         conf_mat_vec = IntVector()
         _oll.oll_testFile(self, testfile, conf_mat_vec, verb)
-        conf_mat_vec = [i for i in conf_mat_vec]
-        correct = conf_mat_vec[0] + conf_mat_vec[3]
-        total = sum(conf_mat_vec)
-        return {
-            'accuracy': correct * 100 / total,
-            'true-positive': conf_mat_vec[0],
-            'false-negative': conf_mat_vec[1],
-            'false-positive': conf_mat_vec[2],
-            'true-negative': conf_mat_vec[3]
-        }
+        return _confusion_matrix([i for i in conf_mat_vec])
+
+    def evaluate(self, X, y=None, n_jobs=1):
+        """
+        testFile on examples in memory
+
+        Args:
+            X : Dataset, numpy.ndarray or scipy.sparse matrix,
+                shape = (n_samples, self.n_features)
+            y : labels of a matrix (a Dataset has its own)
+            n_jobs : number of scoring threads
+        Return:
+            <dict <str>, <float>> confusion_matrix
+        """
+        self._check_idle()
+        if not isinstance(X, Dataset):
+            X = Dataset(X, y)
+        elif y is not None:
+            raise ValueError('a Dataset has its own labels')
+        return _confusion_matrix(
+            _oll.oll_testDataset(self, X._store, X._index, n_jobs))
 
     def setC(self, C):
         """
         Arg:
             <float> C
         """
+        self._check_idle()
+        ret = _oll.oll_setC(self, C)
         self.C = C
-        return _oll.oll_setC(self, C)
+        return ret
 
     def setBias(self, bias):
         """
         Arg:
             <float> bias
         """
+        self._check_idle()
+        ret = _oll.oll_setBias(self, bias)
         self.bias = bias
-        return _oll.oll_setBias(self, bias)
+        return ret
 
     def add(self, example, y):
         """
         Args:
-            <dict <int>, <float>> example: feature vector
+            <dict <int>, <float>> example: feature vector, or a pair
+            (ids, values) of sequences, array.array or numpy arrays
             <float> y
         """
         if y != 1 and y != -1:
             raise ValueError('y is not +1 nor -1')
-        fv = FeatureVector()
-        for (_id, value) in example.items():
-            fv.push_back(IntFloatPair(_id, value))
-        self.train_method(fv, y)
-
-    def _array_to_feature_vector(self, x):
-        fv = FeatureVector()
-        if hasattr(x, 'indices'):  # for sparse matrix
-            indices = map(int, x.indices)
-            values = map(float, x.data)
+        self._check_trainable()
+        _oll.oll_trainExample(self, self.train_method_id, example, int(y))
+
+    def _train_matrix(self, X, y, iter=1):
+        if isinstance(X, Dataset):
+            if y is not None:
+                raise ValueError('a Dataset has its own labels')
+            self._check_trainable()
+            _oll.oll_trainDataset(self, self.train_method_id,
+                                  X._store, X._index, iter)
+            return
+        y = _labels(y)
+        self._check_trainable()
+        buffers = _matrix_buffers(X)
+        if len(buffers) == 3:
+            _oll.oll_trainCSR(self, self.train_method_id,
+                              *(buffers + (y, iter)))
         else:
-            nonzero = x.nonzero()
-            indices = map(int, nonzero[0])
-            values = map(float, x[nonzero])
-        for (_id, value) in zip(indices, values):
-            fv.push_back(IntFloatPair(_id, value))
-        return fv
+            _oll.oll_trainDense(self, self.train_method_id,
+                                buffers[0], y, iter)
 
-    def fit(self, X, y):
+    def fit(self, X, y=None):
         """
-        train examples from numpy/scipy array
+        train examples from numpy/scipy array or Dataset
+
+        The rows are read in place by the C++ library, which runs the
+        training loop without holding the GIL.
 
         Args
-        X : numpy.ndarray or scipy.sparse matrix,
+        X : Dataset, numpy.ndarray or scipy.sparse matrix,
             shape = (n_samples, self.n_features)
-        y : iterable
+        y : iterable (None for a Dataset)
         """
-        assert all(_y in (1, -1) for _y in y)
-        for (i, y_i) in enumerate(map(int, y)):
-            fv = self._array_to_feature_vector(X[i])
-            self.train_method(fv, y_i)
+        self._train_matrix(X, y)
         return self
 
-    def decision_function(self, X):
+    def fit_async(self, X, y=None, iter=1, n_jobs=1, parallel=HOGWILD):
+        """
+        train in a native thread and return at once
+
+        The GIL is released for the whole run. A file is read by that
+        thread too; a matrix is converted to a Dataset first.
+
+        Args
+        X : <str> libsvm file, Dataset, numpy.ndarray or scipy.sparse
+            matrix, shape = (n_samples, self.n_features)
+        y : iterable (None for a file or a Dataset)
+        iter : passes over the examples
+        n_jobs : training threads for a file
+        parallel : HOGWILD (P, PA, PA1, PA2 and CW, with shared weights)
+            or MIX (all but PAK, reproducible for a given n_jobs); the
+            other algorithms are trained in one thread
+        Return
+        future : TrainingFuture, its result() is this model
+        """
+        self._check_trainable()
+        if isinstance(X, str):
+            (source, index) = (X, None)
+        else:
+            if not isinstance(X, Dataset):
+                X = Dataset(X, y)
+            elif y is not None:
+                raise ValueError('a Dataset has its own labels')
+            (source, index) = (X._store, X._index)
+        job = _oll.oll_trainAsync(self, self.train_method_id, source, index,
+                                  iter, n_jobs, parallel)
+        self._future = TrainingFuture(self, job)
+        return self._future
+
+    def partial_fit(self, X, y=None, classes=None):
+        """
+        train one mini-batch of examples from numpy/scipy array
+
+        The whole chunk is handed to the C++ library in one call and the
+        model goes on from its current state, so that a stream too large
+        for memory can be learned chunk by chunk.
+
+        Args
+        X : Dataset, numpy.ndarray or scipy.sparse matrix,
+            shape = (n_samples, self.n_features)
+        y : iterable (None for a Dataset)
+        classes : labels of the whole stream, only checked (1 and -1)
+        """
+        if classes is not None:
+            assert all(c in (1, -1) for c in classes)
+        self._train_matrix(X, y)
+        return self
+
+    def decision_function(self, X, n_jobs=1):
         """
         predict examples from numpy/scipy array
 
+        X is read in place and scored by the C++ library in blocks of rows,
+        with the GIL released.
+
         Args
-        X : numpy.ndarray or scipy.sparse matrix,
+        X : Dataset, numpy.ndarray or scipy.sparse matrix,
             shape = (n_samples, self.n_features)
+        n_jobs : number of scoring threads
         Return
-        scores : list of float
+        scores : numpy.ndarray of float32, shape = (n_samples,)
         """
-        scores = []
-        for i in range(X.shape[0]):
-            fv = self._array_to_feature_vector(X[i])
-            scores.append(_oll.oll_classify(self, fv))
+        self._check_idle()
+        if isinstance(X, Dataset):
+            scores = np.empty(len(X), dtype=np.float32)
+            _oll.oll_classifyDataset(self, X._store, X._index, scores, n_jobs)
+            return scores
+        buffers = _matrix_buffers(X)
+        scores = np.empty(X.shape[0], dtype=np.float32)
+        if len(buffers) == 3:
+            _oll.oll_classifyCSR(self, *(buffers + (scores, n_jobs)))
+        else:
+            _oll.oll_classifyDense(self, buffers[0], scores, n_jobs)
         return scores
 
-    def predict(self, X):
+    def predict(self, X, n_jobs=1):
         """
         predict examples from numpy/scipy array
 
         Args
-        X : numpy.ndarray or scipy.sparse matrix,
+        X : Dataset, numpy.ndarray or scipy.sparse matrix,
             shape = (n_samples, self.n_features)
+        n_jobs : number of scoring threads
         Return
-        labels : list (it takes 1 or -1)
-        """
-        X = X.astype('float32')
-        labels = []
-        for i in range(X.shape[0]):
-            fv = self._array_to_feature_vector(X[i])
-            score = _oll.oll_classify(self, fv)
-            labels.append(1 if score > 0 else -1)
-        return labels
+        labels : numpy.ndarray of int (it takes 1 or -1)
+        """
+        return np.where(self.decision_function(X, n_jobs) > 0, 1, -1)
 
 
 oll_swigregister = _oll.oll_swigregister
@@ -9,6 +9,7 @@
  * ----------------------------------------------------------------------------- */
 
 #define SWIGPYTHON
+#define SWIG_PYTHON_THREADS
 #define SWIG_PYTHON_DIRECTOR_NO_VTABLE
 
 
@@ -1052,7 +1053,11 @@ SWIG_Python_AddErrorMsg(const char* mesg)
 #  endif
 #  if defined(SWIG_PYTHON_USE_GIL) /* Use PyGILState threads calls */
 #    ifndef SWIG_PYTHON_INITIALIZE_THREADS
-#     define SWIG_PYTHON_INITIALIZE_THREADS  PyEval_InitThreads() 
+#     if PY_VERSION_HEX < 0x03070000
+#      define SWIG_PYTHON_INITIALIZE_THREADS  PyEval_InitThreads()
+#     else
+#      define SWIG_PYTHON_INITIALIZE_THREADS
+#     endif
 #    endif
 #    ifdef __cplusplus /* C++ code */
        class SWIG_Python_Thread_Block {
@@ -5126,6 +5131,441 @@ SWIGINTERN void std_vector_Sl_std_pair_Sl_int_Sc_float_Sg__Sg__append(std::vecto
 #include "oll.hpp"
 
 
+/* Matrices handed over through the buffer protocol. The buffers are read in
+   place and wrapped in the row sources of oll.hpp. */
+#include <stdint.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace oll_buffer {
+  /* RAII Py_buffer, declared at the top of a wrapper so that SWIG_fail may jump over nothing */
+  struct view {
+    Py_buffer b;
+    bool held;
+    view() : held(false) {}
+    ~view() { if (held) PyBuffer_Release(&b); }
+    int get(PyObject *obj, int flags) {
+      held = (PyObject_GetBuffer(obj, &b, flags) == 0);
+      return held ? 0 : -1;
+    }
+  };
+
+  /* RAII use of a model by a wrapper, declared at the top like view. With
+     the GIL released, Python threads are no longer serialized: scoring
+     calls (READ) may overlap, any other call has the model alone. An
+     overlap raises RuntimeError rather than racing on the vectors. */
+  struct modelUse {
+    enum mode { READ, WRITE };
+    const void *model;
+    mode m;
+    modelUse() : model(0), m(READ) {}
+    ~modelUse() {
+      if (!model) return;
+      std::lock_guard<std::mutex> g(lock());
+      int &n = uses()[model];
+      n = m == WRITE ? 0 : n - 1;
+      if (n == 0) uses().erase(model);
+    }
+    int enter(const void *model_, mode m_) {
+      std::lock_guard<std::mutex> g(lock());
+      std::unordered_map<const void *, int>::iterator it = uses().find(model_);
+      const int n = it == uses().end() ? 0 : it->second;
+      if (m_ == WRITE ? n != 0 : n < 0) {
+        PyErr_SetString(PyExc_RuntimeError, "the model is in use by another thread");
+        return -1;
+      }
+      uses()[model_] = m_ == WRITE ? -1 : n + 1;
+      model = model_;
+      m = m_;
+      return 0;
+    }
+    /* readers of each model in use, -1 for a writer */
+    static std::unordered_map<const void *, int> &uses() {
+      static std::unordered_map<const void *, int> u;
+      return u;
+    }
+    static std::mutex &lock() {
+      static std::mutex l;
+      return l;
+    }
+  };
+
+  /* 'i': signed integer, 'f': floating point, 0: anything else */
+  SWIGINTERN char kind(const Py_buffer &b) {
+    const char *f = b.format ? b.format : "B";
+    if (*f == '@' || *f == '=') f++;
+#if PY_LITTLE_ENDIAN
+    else if (*f == '<') f++;
+#else
+    else if (*f == '>' || *f == '!') f++;
+#endif
+    if (f[0] == '\0' || f[1] != '\0') return 0;
+    switch (*f) {
+    case 'b': case 'h': case 'i': case 'l': case 'q': case 'n':
+      return (b.itemsize == 4 || b.itemsize == 8) ? 'i' : 0;
+    case 'f': case 'd':
+      return (b.itemsize == 4 || b.itemsize == 8) ? 'f' : 0;
+    }
+    return 0;
+  }
+
+  SWIGINTERN bool isVector(const Py_buffer &b, char k) {
+    return b.ndim == 1 && kind(b) == k;
+  }
+
+  /* indptr must be non-decreasing within [0, nnz] and indices within [0, INT_MAX] */
+  template<class I>
+  bool checkCSR(const I *indptr, size_t n, const I *indices, size_t nnz) {
+    if (indptr[0] < 0 || (size_t)indptr[n] > nnz) return false;
+    for (size_t i = 0; i < n; i++) {
+      if (indptr[i+1] < indptr[i]) return false;
+    }
+    for (size_t k = 0; k < nnz; k++) {
+      if (indices[k] < 0 || (long long)indices[k] > INT_MAX) return false;
+    }
+    return true;
+  }
+
+  template<class I, class V, class F>
+  int applyCSR(const Py_buffer &indptr, const Py_buffer &indices, const Py_buffer &data, F &f) {
+    const size_t n = (size_t)indptr.shape[0] - 1;
+    const size_t nnz = (size_t)indices.shape[0];
+    const I *p = (const I *)indptr.buf;
+    const I *ix = (const I *)indices.buf;
+    if (!checkCSR(p, n, ix, nnz)) return -1;
+    return f(oll_tool::csrRows<I, V>(p, ix, (const V *)data.buf, n));
+  }
+
+  /* Calls f(rows) with the csrRows matching the buffer types. Returns -1
+     for malformed buffers, else what f returns. */
+  template<class F>
+  int withCSR(const Py_buffer &indptr, const Py_buffer &indices, const Py_buffer &data, F &f) {
+    if (!isVector(indptr, 'i') || !isVector(indices, 'i') || !isVector(data, 'f')) return -1;
+    if (indptr.itemsize != indices.itemsize || indptr.shape[0] < 1) return -1;
+    if (indices.shape[0] != data.shape[0]) return -1;
+    if (indptr.itemsize == 4) {
+      if (data.itemsize == 4) return applyCSR<int32_t, float>(indptr, indices, data, f);
+      return applyCSR<int32_t, double>(indptr, indices, data, f);
+    }
+    if (data.itemsize == 4) return applyCSR<int64_t, float>(indptr, indices, data, f);
+    return applyCSR<int64_t, double>(indptr, indices, data, f);
+  }
+
+  /* Calls f(rows) with the denseRows over a 2-d buffer (any strides) */
+  template<class F>
+  int withDense(const Py_buffer &x, F &f) {
+    if (x.ndim != 2 || kind(x) != 'f') return -1;
+    if (x.strides[0] % x.itemsize || x.strides[1] % x.itemsize) return -1;
+    const size_t n = (size_t)x.shape[0], d = (size_t)x.shape[1];
+    const ptrdiff_t rs = x.strides[0] / x.itemsize, cs = x.strides[1] / x.itemsize;
+    if (x.itemsize == 4) return f(oll_tool::denseRows<float>((const float *)x.buf, n, d, rs, cs));
+    return f(oll_tool::denseRows<double>((const double *)x.buf, n, d, rs, cs));
+  }
+
+  SWIGINTERN bool isLabels(const Py_buffer &y) {
+    return isVector(y, 'i') && y.itemsize == 4;
+  }
+
+  struct trainer {
+    oll_tool::oll *ol;
+    oll_tool::trainMethod tm;
+    const int *ys;
+    size_t yN;
+    int iter;
+    template<class R>
+    int operator()(const R &rows) {
+      if (rows.size() != yN) return -1;
+      return ol->trainRows(tm, rows, ys, iter);
+    }
+  };
+
+  SWIGINTERN bool isScores(const Py_buffer &out) {
+    return isVector(out, 'f') && out.itemsize == 4;
+  }
+
+  SWIGINTERN int setId(PyObject *obj, int &id) {
+    if (!PyLong_Check(obj)
+#if PY_VERSION_HEX < 0x03000000
+        && !PyInt_Check(obj)
+#endif
+        ) {
+      PyErr_SetString(PyExc_NotImplementedError, "feature ids must be int");
+      return -1;
+    }
+    const long v = PyLong_AsLong(obj);
+    if (v == -1 && PyErr_Occurred()) return -1;
+    if (v < INT_MIN || v > INT_MAX) {
+      PyErr_SetString(PyExc_OverflowError, "feature id out of range");
+      return -1;
+    }
+    id = (int)v;
+    return 0;
+  }
+
+  SWIGINTERN int setValue(PyObject *obj, float &value) {
+    const double v = PyFloat_AsDouble(obj);
+    if (v == -1.0 && PyErr_Occurred()) return -1;
+    value = (float)v;
+    return 0;
+  }
+
+  /* Appends the entries of one side of an (ids, values) pair: a 1-d
+     buffer of integers or floats is read in place, anything else is
+     iterated as a sequence. */
+  template<bool IDS>
+  int appendSide(PyObject *obj, oll_tool::fv_t &fv, size_t n) {
+    if (PyObject_CheckBuffer(obj)) {
+      view v;
+      if (v.get(obj, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0 && v.b.ndim == 1
+          && kind(v.b) == (IDS ? 'i' : 'f')) {
+        if ((size_t)v.b.shape[0] != n) {
+          PyErr_SetString(PyExc_ValueError, "ids and values differ in length");
+          return -1;
+        }
+        for (size_t i = 0; i < n; i++) {
+          const char *p = (const char *)v.b.buf + i * v.b.itemsize;
+          if (IDS) {
+            const long long id = v.b.itemsize == 4 ? *(const int32_t *)p : *(const int64_t *)p;
+            if (id < INT_MIN || id > INT_MAX) {
+              PyErr_SetString(PyExc_OverflowError, "feature id out of range");
+              return -1;
+            }
+            fv[i].first = (int)id;
+          } else {
+            fv[i].second = v.b.itemsize == 4 ? *(const float *)p : (float)*(const double *)p;
+          }
+        }
+        return 0;
+      }
+      PyErr_Clear();
+    }
+    PyObject *seq = PySequence_Fast(obj, "ids and values must be sequences");
+    if (!seq) return -1;
+    if ((size_t)PySequence_Fast_GET_SIZE(seq) != n) {
+      Py_DECREF(seq);
+      PyErr_SetString(PyExc_ValueError, "ids and values differ in length");
+      return -1;
+    }
+    PyObject **items = PySequence_Fast_ITEMS(seq);
+    for (size_t i = 0; i < n; i++) {
+      if (IDS ? setId(items[i], fv[i].first) : setValue(items[i], fv[i].second)) {
+        Py_DECREF(seq);
+        return -1;
+      }
+    }
+    Py_DECREF(seq);
+    return 0;
+  }
+
+  /* Fills fv from a dict {id: value} or a pair (ids, values). Ids must be
+     ints, as with IntFloatPair; -1 with a Python error set otherwise. */
+  SWIGINTERN int toFeatureVector(PyObject *x, oll_tool::fv_t &fv) {
+    fv.clear();
+    if (PyDict_Check(x)) {
+      fv.resize((size_t)PyDict_Size(x));
+      Py_ssize_t pos = 0;
+      PyObject *key, *value;
+      for (size_t i = 0; PyDict_Next(x, &pos, &key, &value); i++) {
+        if (setId(key, fv[i].first) || setValue(value, fv[i].second)) return -1;
+      }
+      return 0;
+    }
+    if (PyTuple_Check(x) && PyTuple_GET_SIZE(x) == 2) {
+      const Py_ssize_t n = PyObject_Length(PyTuple_GET_ITEM(x, 0));
+      if (n < 0) return -1;
+      fv.resize((size_t)n);
+      if (appendSide<true>(PyTuple_GET_ITEM(x, 0), fv, (size_t)n)) return -1;
+      return appendSide<false>(PyTuple_GET_ITEM(x, 1), fv, (size_t)n);
+    }
+    PyErr_SetString(PyExc_TypeError, "example must be a dict or a pair (ids, values)");
+    return -1;
+  }
+
+  /* oll_tool::dataset objects are handed to Python as capsules owning them */
+  SWIGINTERN void dataset_free(PyObject *capsule) {
+    delete (oll_tool::dataset *)PyCapsule_GetPointer(capsule, "oll_tool::dataset");
+  }
+
+  SWIGINTERN oll_tool::dataset *asDataset(PyObject *obj) {
+    return (oll_tool::dataset *)PyCapsule_GetPointer(obj, "oll_tool::dataset");
+  }
+
+  /* Rows of d selected by the index buffer idx, all rows for None. The
+     indices are checked and then read in place while v is held. */
+  SWIGINTERN int datasetRows(const oll_tool::dataset &d, PyObject *idx, view &v, const size_t *&p, size_t &n) {
+    p = NULL;
+    n = d.size();
+    if (idx == Py_None) return 0;
+    if (v.get(idx, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) return -1;
+    if (!isVector(v.b, 'i') || v.b.itemsize != sizeof(size_t)) {
+      PyErr_SetString(PyExc_TypeError, "row indices must be a 1-d intp buffer");
+      return -1;
+    }
+    p = (const size_t *)v.b.buf;
+    n = (size_t)v.b.shape[0];
+    for (size_t i = 0; i < n; i++) {
+      if (p[i] >= d.size()) {
+	PyErr_SetString(PyExc_IndexError, "row index out of range");
+	return -1;
+      }
+    }
+    return 0;
+  }
+
+  struct appender {
+    oll_tool::dataset *d;
+    const int *ys;
+    size_t yN;
+    template<class R>
+    int operator()(const R &rows) {
+      if (rows.size() != yN) return -1;
+      d->append(rows, ys);
+      return 0;
+    }
+  };
+
+  /* oll_tool::trainJob handed to Python as a capsule. It holds references
+     to the model and to the examples it trains on (none for a save). When
+     the capsule goes away, a training run is cancelled and waited for; a
+     save, which writes a snapshot and no longer needs the model, is left
+     to finish on its own. */
+  struct asyncTrain {
+    oll_tool::oll *ol;
+    oll_tool::trainJob *job;
+    PyObject *refs;
+    bool detached; /* a save */
+  };
+
+  SWIGINTERN void asyncTrain_free(PyObject *capsule) {
+    asyncTrain *a = (asyncTrain *)PyCapsule_GetPointer(capsule, "oll_tool::trainJob");
+    oll_tool::trainJob *job = a->job;
+    if (a->detached) {
+      std::thread([job]() { job->wait(-1); delete job; }).detach();
+    } else {
+      SWIG_PYTHON_THREAD_BEGIN_ALLOW; /* the worker never takes the GIL */
+      delete job;
+      SWIG_PYTHON_THREAD_END_ALLOW;
+    }
+    Py_XDECREF(a->refs);
+    delete a;
+  }
+
+  SWIGINTERN asyncTrain *asAsyncTrain(PyObject *obj) {
+    return (asyncTrain *)PyCapsule_GetPointer(obj, "oll_tool::trainJob");
+  }
+
+  /* oll_tool::mappedModel objects are handed to Python as capsules owning them */
+  SWIGINTERN void mappedModel_free(PyObject *capsule) {
+    delete (oll_tool::mappedModel *)PyCapsule_GetPointer(capsule, "oll_tool::mappedModel");
+  }
+
+  SWIGINTERN oll_tool::mappedModel *asMappedModel(PyObject *obj) {
+    return (oll_tool::mappedModel *)PyCapsule_GetPointer(obj, "oll_tool::mappedModel");
+  }
+
+  /* Read-only 1-d float32 buffer over model storage. It holds a reference
+     to the owner (the proxy of the model) so that the storage outlives every
+     array made from it, and supports weak references so that the proxy can
+     tell whether views are still alive before it trains. */
+  struct paramView {
+    PyObject_HEAD
+    PyObject *owner;
+    const float *data;
+    Py_ssize_t n;
+    Py_ssize_t stride;
+    PyObject *weakrefs;
+  };
+
+  SWIGINTERN int paramView_getbuffer(PyObject *self, Py_buffer *view, int flags) {
+    paramView *v = (paramView *)self;
+    if (flags & PyBUF_WRITABLE) {
+      PyErr_SetString(PyExc_BufferError, "model parameters are read-only");
+      view->obj = NULL;
+      return -1;
+    }
+    view->buf = (void *)v->data;
+    view->obj = self;
+    Py_INCREF(self);
+    view->len = v->n * v->stride;
+    view->readonly = 1;
+    view->itemsize = v->stride;
+    view->format = (flags & PyBUF_FORMAT) ? (char *)"f" : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) ? &v->n : NULL;
+    view->strides = ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) ? &v->stride : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+  }
+
+  SWIGINTERN void paramView_dealloc(PyObject *self) {
+    paramView *v = (paramView *)self;
+    if (v->weakrefs) PyObject_ClearWeakRefs(self);
+    Py_XDECREF(v->owner);
+    PyObject_Del(self);
+  }
+
+  SWIGINTERN PyTypeObject *paramView_type(void) {
+    static PyBufferProcs buffer_procs;
+    static PyTypeObject type;
+    static int type_init = 0;
+    if (!type_init) {
+      const PyTypeObject tmp = {
+#if PY_VERSION_HEX >= 0x03000000
+        PyVarObject_HEAD_INIT(NULL, 0)
+#else
+        PyObject_HEAD_INIT(NULL)
+        0,                                    /* ob_size */
+#endif
+      };
+      type = tmp;
+      buffer_procs.bf_getbuffer = paramView_getbuffer;
+      type.tp_name = (char *)"ParamView";
+      type.tp_basicsize = sizeof(paramView);
+      type.tp_dealloc = paramView_dealloc;
+      type.tp_as_buffer = &buffer_procs;
+      type.tp_flags = Py_TPFLAGS_DEFAULT;
+#if PY_VERSION_HEX < 0x03000000
+      type.tp_flags |= Py_TPFLAGS_HAVE_NEWBUFFER;
+#endif
+      type.tp_doc = (char *)"read-only view of model parameters";
+      type.tp_weaklistoffset = offsetof(paramView, weakrefs);
+      if (PyType_Ready(&type) < 0) return NULL;
+      type_init = 1;
+    }
+    return &type;
+  }
+
+  SWIGINTERN PyObject *newParamView(PyObject *owner, const float *data, size_t n) {
+    PyTypeObject *type = paramView_type();
+    if (!type) return NULL;
+    paramView *v = PyObject_New(paramView, type);
+    if (!v) return NULL;
+    Py_INCREF(owner);
+    v->owner = owner;
+    v->data = data;
+    v->n = (Py_ssize_t)n;
+    v->stride = sizeof(float);
+    v->weakrefs = NULL;
+    return (PyObject *)v;
+  }
+
+  template<class M>
+  struct scorer {
+    const M *ol;
+    float *out;
+    size_t outN;
+    int threadN;
+    template<class R>
+    int operator()(const R &rows) {
+      if (rows.size() != outN) return -1;
+      ol->classifyRows(rows, out, threadN);
+      return 0;
+    }
+  };
+}
+
+
 SWIGINTERN swig_type_info*
 SWIG_pchar_descriptor(void)
 {
@@ -12134,7 +12574,11 @@ SWIGINTERN PyObject *_wrap_trainFile(PyObject *SWIGUNUSEDPARM(self), PyObject *a
     SWIG_exception_fail(SWIG_ArgError(ecode8), "in method '" "trainFile" "', argument " "8"" of type '" "bool""'");
   } 
   arg8 = static_cast< bool >(val8);
-  result = (int)oll_tool::trainFile((char const *)arg1,(char const *)arg2,arg3,arg4,arg5,arg6,arg7,arg8);
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (int)oll_tool::trainFile((char const *)arg1,(char const *)arg2,arg3,arg4,arg5,arg6,arg7,arg8);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_From_int(static_cast< int >(result));
   if (alloc1 == SWIG_NEWOBJ) delete[] buf1;
   if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
@@ -12192,7 +12636,11 @@ SWIGINTERN PyObject *_wrap_testFile(PyObject *SWIGUNUSEDPARM(self), PyObject *ar
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "testFile" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  result = (int)oll_tool::testFile((char const *)arg1,(char const *)arg2,*arg3,arg4);
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (int)oll_tool::testFile((char const *)arg1,(char const *)arg2,*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_From_int(static_cast< int >(result));
   if (alloc1 == SWIG_NEWOBJ) delete[] buf1;
   if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
@@ -12579,6 +13027,7 @@ SWIGINTERN PyObject *_wrap_oll_save(PyObject *SWIGUNUSEDPARM(self), PyObject *ar
   PyObject * obj1 = 0 ;
   int result;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OO:oll_save",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -12590,6 +13039,7 @@ SWIGINTERN PyObject *_wrap_oll_save(PyObject *SWIGUNUSEDPARM(self), PyObject *ar
     SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_save" "', argument " "2"" of type '" "char const *""'");
   }
   arg2 = reinterpret_cast< char * >(buf2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
   result = (int)(arg1)->save((char const *)arg2);
   resultobj = SWIG_From_int(static_cast< int >(result));
   if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
@@ -12600,7 +13050,7 @@ fail:
 }
 
 
-SWIGINTERN PyObject *_wrap_oll_load(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+SWIGINTERN PyObject *_wrap_oll_checkpoint(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
   char *arg2 = (char *) 0 ;
@@ -12613,18 +13063,20 @@ SWIGINTERN PyObject *_wrap_oll_load(PyObject *SWIGUNUSEDPARM(self), PyObject *ar
   PyObject * obj1 = 0 ;
   int result;
   
-  if (!PyArg_ParseTuple(args,(char *)"OO:oll_load",&obj0,&obj1)) SWIG_fail;
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_checkpoint",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_load" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_checkpoint" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
   }
   arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
   res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
   if (!SWIG_IsOK(res2)) {
-    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_load" "', argument " "2"" of type '" "char const *""'");
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_checkpoint" "', argument " "2"" of type '" "char const *""'");
   }
   arg2 = reinterpret_cast< char * >(buf2);
-  result = (int)(arg1)->load((char const *)arg2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  result = (int)(arg1)->checkpoint((char const *)arg2);
   resultobj = SWIG_From_int(static_cast< int >(result));
   if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return resultobj;
@@ -12634,156 +13086,408 @@ fail:
 }
 
 
-SWIGINTERN PyObject *_wrap_oll_classify(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+SWIGINTERN PyObject *_wrap_oll_saveDelta(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
-  oll_tool::fv_t *arg2 = 0 ;
+  char *arg2 = (char *) 0 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
-  int res2 = SWIG_OLDOBJ ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
   PyObject * obj0 = 0 ;
   PyObject * obj1 = 0 ;
-  float result;
+  int result;
   
-  if (!PyArg_ParseTuple(args,(char *)"OO:oll_classify",&obj0,&obj1)) SWIG_fail;
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_saveDelta",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_classify" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_saveDelta" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
   }
   arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
-  {
-    std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *ptr = (std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *)0;
-    res2 = swig::asptr(obj1, &ptr);
-    if (!SWIG_IsOK(res2)) {
-      SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_classify" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
-    }
-    if (!ptr) {
-      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_classify" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
-    }
-    arg2 = ptr;
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_saveDelta" "', argument " "2"" of type '" "char const *""'");
   }
-  result = (float)(arg1)->classify((oll_tool::fv_t const &)*arg2);
-  resultobj = SWIG_From_float(static_cast< float >(result));
-  if (SWIG_IsNewObj(res2)) delete arg2;
+  arg2 = reinterpret_cast< char * >(buf2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  result = (int)(arg1)->saveDelta((char const *)arg2);
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return resultobj;
 fail:
-  if (SWIG_IsNewObj(res2)) delete arg2;
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return NULL;
 }
 
 
-SWIGINTERN PyObject *_wrap_oll_getMargin(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+SWIGINTERN PyObject *_wrap_oll_loadDelta(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
-  oll_tool::fvec *arg2 = 0 ;
-  float arg3 ;
-  oll_tool::fv_t *arg4 = 0 ;
+  char *arg2 = (char *) 0 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
-  int res2 = SWIG_OLDOBJ ;
-  float val3 ;
-  int ecode3 = 0 ;
-  int res4 = SWIG_OLDOBJ ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
   PyObject * obj0 = 0 ;
   PyObject * obj1 = 0 ;
-  PyObject * obj2 = 0 ;
-  PyObject * obj3 = 0 ;
-  float result;
+  int result;
   
-  if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_getMargin",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_loadDelta",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_getMargin" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_loadDelta" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
   }
   arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
-  {
-    std::vector<float,std::allocator< float > > *ptr = (std::vector<float,std::allocator< float > > *)0;
-    res2 = swig::asptr(obj1, &ptr);
-    if (!SWIG_IsOK(res2)) {
-      SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_getMargin" "', argument " "2"" of type '" "oll_tool::fvec const &""'"); 
-    }
-    if (!ptr) {
-      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_getMargin" "', argument " "2"" of type '" "oll_tool::fvec const &""'"); 
-    }
-    arg2 = ptr;
-  }
-  ecode3 = SWIG_AsVal_float(obj2, &val3);
-  if (!SWIG_IsOK(ecode3)) {
-    SWIG_exception_fail(SWIG_ArgError(ecode3), "in method '" "oll_getMargin" "', argument " "3"" of type '" "float""'");
-  } 
-  arg3 = static_cast< float >(val3);
-  {
-    std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *ptr = (std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *)0;
-    res4 = swig::asptr(obj3, &ptr);
-    if (!SWIG_IsOK(res4)) {
-      SWIG_exception_fail(SWIG_ArgError(res4), "in method '" "oll_getMargin" "', argument " "4"" of type '" "oll_tool::fv_t const &""'"); 
-    }
-    if (!ptr) {
-      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_getMargin" "', argument " "4"" of type '" "oll_tool::fv_t const &""'"); 
-    }
-    arg4 = ptr;
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_loadDelta" "', argument " "2"" of type '" "char const *""'");
   }
-  result = (float)((oll_tool::oll const *)arg1)->getMargin((oll_tool::fvec const &)*arg2,arg3,(oll_tool::fv_t const &)*arg4);
-  resultobj = SWIG_From_float(static_cast< float >(result));
-  if (SWIG_IsNewObj(res2)) delete arg2;
-  if (SWIG_IsNewObj(res4)) delete arg4;
+  arg2 = reinterpret_cast< char * >(buf2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  result = (int)(arg1)->loadDelta((char const *)arg2);
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return resultobj;
 fail:
-  if (SWIG_IsNewObj(res2)) delete arg2;
-  if (SWIG_IsNewObj(res4)) delete arg4;
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return NULL;
 }
 
 
-SWIGINTERN PyObject *_wrap_oll_getMarginK(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+SWIGINTERN PyObject *_wrap_oll_compact(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
-  oll_tool::fv_t *arg2 = 0 ;
+  char *arg2 = (char *) 0 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
-  int res2 = SWIG_OLDOBJ ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
   PyObject * obj0 = 0 ;
   PyObject * obj1 = 0 ;
-  float result;
+  int result;
   
-  if (!PyArg_ParseTuple(args,(char *)"OO:oll_getMarginK",&obj0,&obj1)) SWIG_fail;
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_compact",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
-    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_getMarginK" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_compact" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
   }
   arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
-  {
-    std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *ptr = (std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *)0;
-    res2 = swig::asptr(obj1, &ptr);
-    if (!SWIG_IsOK(res2)) {
-      SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_getMarginK" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
-    }
-    if (!ptr) {
-      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_getMarginK" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
-    }
-    arg2 = ptr;
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_compact" "', argument " "2"" of type '" "char const *""'");
   }
-  result = (float)(arg1)->getMarginK((oll_tool::fv_t const &)*arg2);
-  resultobj = SWIG_From_float(static_cast< float >(result));
-  if (SWIG_IsNewObj(res2)) delete arg2;
+  arg2 = reinterpret_cast< char * >(buf2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  result = (int)(arg1)->compact((char const *)arg2);
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return resultobj;
 fail:
-  if (SWIG_IsNewObj(res2)) delete arg2;
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return NULL;
 }
 
 
-SWIGINTERN PyObject *_wrap_oll_getVariance(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+SWIGINTERN PyObject *_wrap_oll_exportModel(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
-  oll_tool::fv_t *arg2 = 0 ;
+  char *arg2 = (char *) 0 ;
+  oll_tool::precision arg3 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
-  int res2 = SWIG_OLDOBJ ;
-  PyObject * obj0 = 0 ;
-  PyObject * obj1 = 0 ;
-  float result;
-  
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
+  int val3 ;
+  int ecode3 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOO:oll_exportModel",&obj0,&obj1,&obj2)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_exportModel" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_exportModel" "', argument " "2"" of type '" "char const *""'");
+  }
+  arg2 = reinterpret_cast< char * >(buf2);
+  ecode3 = SWIG_AsVal_int(obj2, &val3);
+  if (!SWIG_IsOK(ecode3)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode3), "in method '" "oll_exportModel" "', argument " "3"" of type '" "oll_tool::precision""'");
+  } 
+  arg3 = static_cast< oll_tool::precision >(val3);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  result = (int)(arg1)->exportModel((char const *)arg2,arg3);
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return resultobj;
+fail:
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_exportHeader(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  char *arg2 = (char *) 0 ;
+  char *arg3 = (char *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
+  int res3 ;
+  char *buf3 = 0 ;
+  int alloc3 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOO:oll_exportHeader",&obj0,&obj1,&obj2)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_exportHeader" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_exportHeader" "', argument " "2"" of type '" "char const *""'");
+  }
+  arg2 = reinterpret_cast< char * >(buf2);
+  res3 = SWIG_AsCharPtrAndSize(obj2, &buf3, NULL, &alloc3);
+  if (!SWIG_IsOK(res3)) {
+    SWIG_exception_fail(SWIG_ArgError(res3), "in method '" "oll_exportHeader" "', argument " "3"" of type '" "std::string const &""'");
+  }
+  arg3 = reinterpret_cast< char * >(buf3);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  result = (int)(arg1)->exportHeader((char const *)arg2,std::string(arg3));
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  if (alloc3 == SWIG_NEWOBJ) delete[] buf3;
+  return resultobj;
+fail:
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  if (alloc3 == SWIG_NEWOBJ) delete[] buf3;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_load(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  char *arg2 = (char *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
+  oll_tool::loadMode arg3 ;
+  int val3 ;
+  int ecode3 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOO:oll_load",&obj0,&obj1,&obj2)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_load" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_load" "', argument " "2"" of type '" "char const *""'");
+  }
+  arg2 = reinterpret_cast< char * >(buf2);
+  ecode3 = SWIG_AsVal_int(obj2, &val3);
+  if (!SWIG_IsOK(ecode3)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode3), "in method '" "oll_load" "', argument " "3"" of type '" "oll_tool::loadMode""'");
+  } 
+  arg3 = static_cast< oll_tool::loadMode >(val3);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  result = (int)(arg1)->load((char const *)arg2,arg3);
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return resultobj;
+fail:
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_classify(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::fv_t *arg2 = 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 = SWIG_OLDOBJ ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  float result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_classify",&obj0,&obj1)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_classify" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  {
+    std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *ptr = (std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *)0;
+    res2 = swig::asptr(obj1, &ptr);
+    if (!SWIG_IsOK(res2)) {
+      SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_classify" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
+    }
+    if (!ptr) {
+      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_classify" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
+    }
+    arg2 = ptr;
+  }
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (float)((oll_tool::oll const *)arg1)->classify((oll_tool::fv_t const &)*arg2);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  resultobj = SWIG_From_float(static_cast< float >(result));
+  if (SWIG_IsNewObj(res2)) delete arg2;
+  return resultobj;
+fail:
+  if (SWIG_IsNewObj(res2)) delete arg2;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_getMargin(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::fvec *arg2 = 0 ;
+  float arg3 ;
+  oll_tool::fv_t *arg4 = 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 = SWIG_OLDOBJ ;
+  float val3 ;
+  int ecode3 = 0 ;
+  int res4 = SWIG_OLDOBJ ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  float result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_getMargin",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_getMargin" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  {
+    std::vector<float,std::allocator< float > > *ptr = (std::vector<float,std::allocator< float > > *)0;
+    res2 = swig::asptr(obj1, &ptr);
+    if (!SWIG_IsOK(res2)) {
+      SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_getMargin" "', argument " "2"" of type '" "oll_tool::fvec const &""'"); 
+    }
+    if (!ptr) {
+      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_getMargin" "', argument " "2"" of type '" "oll_tool::fvec const &""'"); 
+    }
+    arg2 = ptr;
+  }
+  ecode3 = SWIG_AsVal_float(obj2, &val3);
+  if (!SWIG_IsOK(ecode3)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode3), "in method '" "oll_getMargin" "', argument " "3"" of type '" "float""'");
+  } 
+  arg3 = static_cast< float >(val3);
+  {
+    std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *ptr = (std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *)0;
+    res4 = swig::asptr(obj3, &ptr);
+    if (!SWIG_IsOK(res4)) {
+      SWIG_exception_fail(SWIG_ArgError(res4), "in method '" "oll_getMargin" "', argument " "4"" of type '" "oll_tool::fv_t const &""'"); 
+    }
+    if (!ptr) {
+      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_getMargin" "', argument " "4"" of type '" "oll_tool::fv_t const &""'"); 
+    }
+    arg4 = ptr;
+  }
+  result = (float)((oll_tool::oll const *)arg1)->getMargin((oll_tool::fvec const &)*arg2,arg3,(oll_tool::fv_t const &)*arg4);
+  resultobj = SWIG_From_float(static_cast< float >(result));
+  if (SWIG_IsNewObj(res2)) delete arg2;
+  if (SWIG_IsNewObj(res4)) delete arg4;
+  return resultobj;
+fail:
+  if (SWIG_IsNewObj(res2)) delete arg2;
+  if (SWIG_IsNewObj(res4)) delete arg4;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_getMarginK(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::fv_t *arg2 = 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 = SWIG_OLDOBJ ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  float result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_getMarginK",&obj0,&obj1)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_getMarginK" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  {
+    std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *ptr = (std::vector<std::pair< int,float >,std::allocator< std::pair< int,float > > > *)0;
+    res2 = swig::asptr(obj1, &ptr);
+    if (!SWIG_IsOK(res2)) {
+      SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_getMarginK" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
+    }
+    if (!ptr) {
+      SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_getMarginK" "', argument " "2"" of type '" "oll_tool::fv_t const &""'"); 
+    }
+    arg2 = ptr;
+  }
+  result = (float)((oll_tool::oll const *)arg1)->getMarginK((oll_tool::fv_t const &)*arg2);
+  resultobj = SWIG_From_float(static_cast< float >(result));
+  if (SWIG_IsNewObj(res2)) delete arg2;
+  return resultobj;
+fail:
+  if (SWIG_IsNewObj(res2)) delete arg2;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_getVariance(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::fv_t *arg2 = 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 = SWIG_OLDOBJ ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  float result;
+  
   if (!PyArg_ParseTuple(args,(char *)"OO:oll_getVariance",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -12870,6 +13574,7 @@ SWIGINTERN PyObject *_wrap_oll_testFile__SWIG_0(PyObject *SWIGUNUSEDPARM(self),
   PyObject * obj3 = 0 ;
   int result;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_testFile",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -12894,7 +13599,12 @@ SWIGINTERN PyObject *_wrap_oll_testFile__SWIG_0(PyObject *SWIGUNUSEDPARM(self),
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_testFile" "', argument " "4"" of type '" "bool""'");
   } 
   arg4 = static_cast< bool >(val4);
-  result = (int)(arg1)->testFile((char const *)arg2,*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (int)(arg1)->testFile((char const *)arg2,*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_From_int(static_cast< int >(result));
   if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return resultobj;
@@ -12921,6 +13631,7 @@ SWIGINTERN PyObject *_wrap_oll_testFile__SWIG_1(PyObject *SWIGUNUSEDPARM(self),
   PyObject * obj2 = 0 ;
   int result;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOO:oll_testFile",&obj0,&obj1,&obj2)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -12940,7 +13651,12 @@ SWIGINTERN PyObject *_wrap_oll_testFile__SWIG_1(PyObject *SWIGUNUSEDPARM(self),
     SWIG_exception_fail(SWIG_ValueError, "invalid null reference " "in method '" "oll_testFile" "', argument " "3"" of type '" "std::vector< int,std::allocator< int > > &""'"); 
   }
   arg3 = reinterpret_cast< std::vector< int,std::allocator< int > > * >(argp3);
-  result = (int)(arg1)->testFile((char const *)arg2,*arg3);
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (int)(arg1)->testFile((char const *)arg2,*arg3);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_From_int(static_cast< int >(result));
   if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
   return resultobj;
@@ -13081,6 +13797,7 @@ SWIGINTERN PyObject *_wrap_oll_setC(PyObject *SWIGUNUSEDPARM(self), PyObject *ar
   PyObject * obj0 = 0 ;
   PyObject * obj1 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OO:oll_setC",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13092,6 +13809,7 @@ SWIGINTERN PyObject *_wrap_oll_setC(PyObject *SWIGUNUSEDPARM(self), PyObject *ar
     SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "oll_setC" "', argument " "2"" of type '" "float""'");
   } 
   arg2 = static_cast< float >(val2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
   (arg1)->setC(arg2);
   resultobj = SWIG_Py_Void();
   return resultobj;
@@ -13111,6 +13829,7 @@ SWIGINTERN PyObject *_wrap_oll_setBias(PyObject *SWIGUNUSEDPARM(self), PyObject
   PyObject * obj0 = 0 ;
   PyObject * obj1 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OO:oll_setBias",&obj0,&obj1)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13122,6 +13841,7 @@ SWIGINTERN PyObject *_wrap_oll_setBias(PyObject *SWIGUNUSEDPARM(self), PyObject
     SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "oll_setBias" "', argument " "2"" of type '" "float""'");
   } 
   arg2 = static_cast< float >(val2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
   (arg1)->setBias(arg2);
   resultobj = SWIG_Py_Void();
   return resultobj;
@@ -13130,15 +13850,59 @@ fail:
 }
 
 
-SWIGINTERN PyObject *_wrap_oll_getErrorLog(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+SWIGINTERN PyObject *_wrap_oll_getExampleN(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *resultobj = 0;
   oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
   void *argp1 = 0 ;
   int res1 = 0 ;
   PyObject * obj0 = 0 ;
-  std::string result;
+  size_t result;
   
-  if (!PyArg_ParseTuple(args,(char *)"O:oll_getErrorLog",&obj0)) SWIG_fail;
+  if (!PyArg_ParseTuple(args,(char *)"O:oll_getExampleN",&obj0)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_getExampleN" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  result = ((oll_tool::oll const *)arg1)->getExampleN();
+  resultobj = SWIG_From_size_t(static_cast< size_t >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_isTrainable(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  PyObject * obj0 = 0 ;
+  bool result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:oll_isTrainable",&obj0)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_isTrainable" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  result = ((oll_tool::oll const *)arg1)->isTrainable();
+  resultobj = SWIG_From_bool(static_cast< bool >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_getErrorLog(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  PyObject * obj0 = 0 ;
+  std::string result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:oll_getErrorLog",&obj0)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
     SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_getErrorLog" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
@@ -13192,6 +13956,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleP(PyObject *SWIGUNUSEDPARM(self), PyO
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExampleP",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13222,7 +13987,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleP(PyObject *SWIGUNUSEDPARM(self), PyO
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExampleP" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::P_s >((oll_tool::P_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::P_s >((oll_tool::P_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13250,6 +14020,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleAP(PyObject *SWIGUNUSEDPARM(self), Py
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExampleAP",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13280,7 +14051,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleAP(PyObject *SWIGUNUSEDPARM(self), Py
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExampleAP" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::AP_s >((oll_tool::AP_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::AP_s >((oll_tool::AP_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13308,6 +14084,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePA(PyObject *SWIGUNUSEDPARM(self), Py
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExamplePA",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13338,7 +14115,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePA(PyObject *SWIGUNUSEDPARM(self), Py
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExamplePA" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PA_s >((oll_tool::PA_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PA_s >((oll_tool::PA_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13366,6 +14148,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePA1(PyObject *SWIGUNUSEDPARM(self), P
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExamplePA1",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13396,7 +14179,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePA1(PyObject *SWIGUNUSEDPARM(self), P
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExamplePA1" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PA1_s >((oll_tool::PA1_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PA1_s >((oll_tool::PA1_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13424,6 +14212,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePA2(PyObject *SWIGUNUSEDPARM(self), P
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExamplePA2",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13454,7 +14243,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePA2(PyObject *SWIGUNUSEDPARM(self), P
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExamplePA2" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PA2_s >((oll_tool::PA2_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PA2_s >((oll_tool::PA2_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13482,6 +14276,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePAK(PyObject *SWIGUNUSEDPARM(self), P
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExamplePAK",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13512,7 +14307,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExamplePAK(PyObject *SWIGUNUSEDPARM(self), P
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExamplePAK" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PAK_s >((oll_tool::PAK_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::PAK_s >((oll_tool::PAK_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13540,6 +14340,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleCW(PyObject *SWIGUNUSEDPARM(self), Py
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExampleCW",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13570,7 +14371,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleCW(PyObject *SWIGUNUSEDPARM(self), Py
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExampleCW" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::CW_s >((oll_tool::CW_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::CW_s >((oll_tool::CW_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13598,6 +14404,7 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleAL(PyObject *SWIGUNUSEDPARM(self), Py
   PyObject * obj2 = 0 ;
   PyObject * obj3 = 0 ;
   
+  oll_buffer::modelUse use ;
   if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExampleAL",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
   res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
   if (!SWIG_IsOK(res1)) {
@@ -13628,7 +14435,12 @@ SWIGINTERN PyObject *_wrap_oll_trainExampleAL(PyObject *SWIGUNUSEDPARM(self), Py
     SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExampleAL" "', argument " "4"" of type '" "int""'");
   } 
   arg4 = static_cast< int >(val4);
-  (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::AL_s >((oll_tool::AL_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    (arg1)->SWIGTEMPLATEDISAMBIGUATOR trainExample< oll_tool::AL_s >((oll_tool::AL_s const &)*arg2,(oll_tool::fv_t const &)*arg3,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
   resultobj = SWIG_Py_Void();
   if (SWIG_IsNewObj(res3)) delete arg3;
   return resultobj;
@@ -13638,6 +14450,1198 @@ fail:
 }
 
 
+SWIGINTERN PyObject *_wrap_oll_trainCSR(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::trainMethod arg2 ;
+  int arg7 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val2 ;
+  int ecode2 = 0 ;
+  int val7 ;
+  int ecode7 = 0 ;
+  oll_buffer::view indptr, indices, data, y ;
+  oll_buffer::trainer f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  PyObject * obj5 = 0 ;
+  PyObject * obj6 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOOOOO:oll_trainCSR",&obj0,&obj1,&obj2,&obj3,&obj4,&obj5,&obj6)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_trainCSR" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  ecode2 = SWIG_AsVal_int(obj1, &val2);
+  if (!SWIG_IsOK(ecode2)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "oll_trainCSR" "', argument " "2"" of type '" "oll_tool::trainMethod""'");
+  } 
+  arg2 = static_cast< oll_tool::trainMethod >(val2);
+  if (indptr.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (indices.get(obj3, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (data.get(obj4, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (y.get(obj5, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (!oll_buffer::isLabels(y.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "oll_trainCSR" "', argument " "5"" of type '" "int32 vector""'");
+  }
+  ecode7 = SWIG_AsVal_int(obj6, &val7);
+  if (!SWIG_IsOK(ecode7)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode7), "in method '" "oll_trainCSR" "', argument " "7"" of type '" "int""'");
+  } 
+  arg7 = static_cast< int >(val7);
+  f.ol = arg1;
+  f.tm = arg2;
+  f.ys = (const int *)y.b.buf;
+  f.yN = (size_t)y.b.shape[0];
+  f.iter = arg7;
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withCSR(indptr.b, indices.b, data.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "oll_trainCSR" "', malformed CSR buffers or label count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_trainDense(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::trainMethod arg2 ;
+  int arg5 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val2 ;
+  int ecode2 = 0 ;
+  int val5 ;
+  int ecode5 = 0 ;
+  oll_buffer::view x, y ;
+  oll_buffer::trainer f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOOO:oll_trainDense",&obj0,&obj1,&obj2,&obj3,&obj4)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_trainDense" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  ecode2 = SWIG_AsVal_int(obj1, &val2);
+  if (!SWIG_IsOK(ecode2)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "oll_trainDense" "', argument " "2"" of type '" "oll_tool::trainMethod""'");
+  } 
+  arg2 = static_cast< oll_tool::trainMethod >(val2);
+  if (x.get(obj2, PyBUF_STRIDES | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (y.get(obj3, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (!oll_buffer::isLabels(y.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "oll_trainDense" "', argument " "4"" of type '" "int32 vector""'");
+  }
+  ecode5 = SWIG_AsVal_int(obj4, &val5);
+  if (!SWIG_IsOK(ecode5)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode5), "in method '" "oll_trainDense" "', argument " "5"" of type '" "int""'");
+  } 
+  arg5 = static_cast< int >(val5);
+  f.ol = arg1;
+  f.tm = arg2;
+  f.ys = (const int *)y.b.buf;
+  f.yN = (size_t)y.b.shape[0];
+  f.iter = arg5;
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withDense(x.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "oll_trainDense" "', malformed matrix buffer or label count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_classifyCSR(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  int arg6 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val6 ;
+  int ecode6 = 0 ;
+  oll_buffer::view indptr, indices, data, out ;
+  oll_buffer::scorer<oll_tool::oll> f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  PyObject * obj5 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOOOO:oll_classifyCSR",&obj0,&obj1,&obj2,&obj3,&obj4,&obj5)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_classifyCSR" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  if (indptr.get(obj1, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (indices.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (data.get(obj3, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (out.get(obj4, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) == -1) SWIG_fail;
+  if (!oll_buffer::isScores(out.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "oll_classifyCSR" "', argument " "5"" of type '" "float32 vector""'");
+  }
+  ecode6 = SWIG_AsVal_int(obj5, &val6);
+  if (!SWIG_IsOK(ecode6)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode6), "in method '" "oll_classifyCSR" "', argument " "6"" of type '" "int""'");
+  } 
+  arg6 = static_cast< int >(val6);
+  f.ol = arg1;
+  f.out = (float *)out.b.buf;
+  f.outN = (size_t)out.b.shape[0];
+  f.threadN = arg6;
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withCSR(indptr.b, indices.b, data.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "oll_classifyCSR" "', malformed CSR buffers or score count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_classifyDense(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  int arg4 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val4 ;
+  int ecode4 = 0 ;
+  oll_buffer::view x, out ;
+  oll_buffer::scorer<oll_tool::oll> f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_classifyDense",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_classifyDense" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  if (x.get(obj1, PyBUF_STRIDES | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (out.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) == -1) SWIG_fail;
+  if (!oll_buffer::isScores(out.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "oll_classifyDense" "', argument " "3"" of type '" "float32 vector""'");
+  }
+  ecode4 = SWIG_AsVal_int(obj3, &val4);
+  if (!SWIG_IsOK(ecode4)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_classifyDense" "', argument " "4"" of type '" "int""'");
+  } 
+  arg4 = static_cast< int >(val4);
+  f.ol = arg1;
+  f.out = (float *)out.b.buf;
+  f.outN = (size_t)out.b.shape[0];
+  f.threadN = arg4;
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withDense(x.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "oll_classifyDense" "', malformed matrix buffer or score count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_getParam(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  char *arg2 = (char *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
+  size_t n = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  const float *result = 0 ;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_getParam",&obj0,&obj1)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_getParam" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_getParam" "', argument " "2"" of type '" "char const *""'");
+  }
+  arg2 = reinterpret_cast< char * >(buf2);
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  result = ((oll_tool::oll const *)arg1)->getParam(arg2, n);
+  if (result) {
+    resultobj = oll_buffer::newParamView(obj0, result, n);
+    if (!resultobj) SWIG_fail;
+  } else {
+    resultobj = SWIG_Py_Void();
+  }
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return resultobj;
+fail:
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_dumps(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  PyObject * obj0 = 0 ;
+  size_t size ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"O:oll_dumps",&obj0)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_dumps" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  size = (arg1)->saveSize();
+  /* the model is written straight into the storage of the bytes object */
+  resultobj = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)size);
+  if (!resultobj) SWIG_fail;
+  {
+    char *buf = PyBytes_AS_STRING(resultobj);
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (arg1)->save(buf, size);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    Py_DECREF(resultobj);
+    SWIG_exception_fail(SWIG_IOError, ((oll_tool::oll const *)arg1)->getErrorLog().c_str());
+  }
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_loads(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  oll_buffer::view data ;
+  oll_tool::loadMode arg3 ;
+  int val3 ;
+  int ecode3 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOO:oll_loads",&obj0,&obj1,&obj2)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_loads" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  ecode3 = SWIG_AsVal_int(obj2, &val3);
+  if (!SWIG_IsOK(ecode3)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode3), "in method '" "oll_loads" "', argument " "3"" of type '" "oll_tool::loadMode""'");
+  } 
+  arg3 = static_cast< oll_tool::loadMode >(val3);
+  if (data.get(obj1, PyBUF_SIMPLE) == -1) SWIG_fail;
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (arg1)->load((const char *)data.b.buf, (size_t)data.b.len, arg3);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_trainExample(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::trainMethod arg2 ;
+  int arg4 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val2 ;
+  int ecode2 = 0 ;
+  int val4 ;
+  int ecode4 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  static thread_local oll_tool::fv_t fv ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_trainExample",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_trainExample" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  ecode2 = SWIG_AsVal_int(obj1, &val2);
+  if (!SWIG_IsOK(ecode2)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "oll_trainExample" "', argument " "2"" of type '" "oll_tool::trainMethod""'");
+  } 
+  arg2 = static_cast< oll_tool::trainMethod >(val2);
+  if (oll_buffer::toFeatureVector(obj2, fv) == -1) SWIG_fail;
+  ecode4 = SWIG_AsVal_int(obj3, &val4);
+  if (!SWIG_IsOK(ecode4)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_trainExample" "', argument " "4"" of type '" "int""'");
+  } 
+  arg4 = static_cast< int >(val4);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (int)(arg1)->trainExample(arg2,(oll_tool::fv_t const &)fv,arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_classifyExample(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  static thread_local oll_tool::fv_t fv ;
+  float result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_classifyExample",&obj0,&obj1)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_classifyExample" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  if (oll_buffer::toFeatureVector(obj1, fv) == -1) SWIG_fail;
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (float)((oll_tool::oll const *)arg1)->classify((oll_tool::fv_t const &)fv);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  resultobj = SWIG_From_float(static_cast< float >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_new_dataset(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  if (!PyArg_ParseTuple(args,(char *)":new_dataset")) return NULL;
+  return PyCapsule_New(new oll_tool::dataset(), "oll_tool::dataset", oll_buffer::dataset_free);
+}
+
+
+SWIGINTERN PyObject *_wrap_dataset_readFile(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::dataset *arg1 = 0 ;
+  char *arg2 = (char *) 0 ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OO:dataset_readFile",&obj0,&obj1)) SWIG_fail;
+  arg1 = oll_buffer::asDataset(obj0);
+  if (!arg1) SWIG_fail;
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "dataset_readFile" "', argument " "2"" of type '" "char const *""'");
+  }
+  arg2 = reinterpret_cast< char * >(buf2);
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (int)(arg1)->readFile((char const *)arg2);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_IOError, arg1->getErrorLog().c_str());
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return resultobj;
+fail:
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_dataset_appendCSR(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::dataset *arg1 = 0 ;
+  oll_buffer::view indptr, indices, data, y ;
+  oll_buffer::appender f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOOOO:dataset_appendCSR",&obj0,&obj1,&obj2,&obj3,&obj4)) SWIG_fail;
+  arg1 = oll_buffer::asDataset(obj0);
+  if (!arg1) SWIG_fail;
+  if (indptr.get(obj1, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (indices.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (data.get(obj3, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (y.get(obj4, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (!oll_buffer::isLabels(y.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "dataset_appendCSR" "', argument " "5"" of type '" "int32 vector""'");
+  }
+  f.d = arg1;
+  f.ys = (const int *)y.b.buf;
+  f.yN = (size_t)y.b.shape[0];
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withCSR(indptr.b, indices.b, data.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "dataset_appendCSR" "', malformed CSR buffers or label count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_dataset_appendDense(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::dataset *arg1 = 0 ;
+  oll_buffer::view x, y ;
+  oll_buffer::appender f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOO:dataset_appendDense",&obj0,&obj1,&obj2)) SWIG_fail;
+  arg1 = oll_buffer::asDataset(obj0);
+  if (!arg1) SWIG_fail;
+  if (x.get(obj1, PyBUF_STRIDES | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (y.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (!oll_buffer::isLabels(y.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "dataset_appendDense" "', argument " "3"" of type '" "int32 vector""'");
+  }
+  f.d = arg1;
+  f.ys = (const int *)y.b.buf;
+  f.yN = (size_t)y.b.shape[0];
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withDense(x.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "dataset_appendDense" "', malformed matrix buffer or label count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_dataset_size(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::dataset *arg1 = 0 ;
+  PyObject * obj0 = 0 ;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:dataset_size",&obj0)) return NULL;
+  arg1 = oll_buffer::asDataset(obj0);
+  if (!arg1) return NULL;
+  return SWIG_From_size_t(arg1->size());
+}
+
+
+SWIGINTERN PyObject *_wrap_dataset_labels(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::dataset *arg1 = 0 ;
+  oll_buffer::view idx, out ;
+  const size_t *p = 0 ;
+  size_t n = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOO:dataset_labels",&obj0,&obj1,&obj2)) SWIG_fail;
+  arg1 = oll_buffer::asDataset(obj0);
+  if (!arg1) SWIG_fail;
+  if (oll_buffer::datasetRows(*arg1, obj1, idx, p, n) == -1) SWIG_fail;
+  if (out.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) == -1) SWIG_fail;
+  if (!oll_buffer::isLabels(out.b) || (size_t)out.b.shape[0] != n) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "dataset_labels" "', argument " "3"" of type '" "int32 vector of the row count""'");
+  }
+  {
+    const oll_tool::dataset::rows rows(*arg1, p, n);
+    int *ys = (int *)out.b.buf;
+    for (size_t i = 0; i < n; i++) ys[i] = rows.label(i);
+  }
+  return SWIG_Py_Void();
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_trainDataset(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::trainMethod arg2 ;
+  oll_tool::dataset *arg3 = 0 ;
+  int arg5 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val2 ;
+  int ecode2 = 0 ;
+  int val5 ;
+  int ecode5 = 0 ;
+  oll_buffer::view idx ;
+  const size_t *p = 0 ;
+  size_t n = 0 ;
+  std::vector<int> ys ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  int result;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOOO:oll_trainDataset",&obj0,&obj1,&obj2,&obj3,&obj4)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_trainDataset" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  ecode2 = SWIG_AsVal_int(obj1, &val2);
+  if (!SWIG_IsOK(ecode2)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "oll_trainDataset" "', argument " "2"" of type '" "oll_tool::trainMethod""'");
+  } 
+  arg2 = static_cast< oll_tool::trainMethod >(val2);
+  arg3 = oll_buffer::asDataset(obj2);
+  if (!arg3) SWIG_fail;
+  if (oll_buffer::datasetRows(*arg3, obj3, idx, p, n) == -1) SWIG_fail;
+  ecode5 = SWIG_AsVal_int(obj4, &val5);
+  if (!SWIG_IsOK(ecode5)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode5), "in method '" "oll_trainDataset" "', argument " "5"" of type '" "int""'");
+  } 
+  arg5 = static_cast< int >(val5);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    const oll_tool::dataset::rows rows(*arg3, p, n);
+    rows.labels(ys);
+    result = (arg1)->trainRows(arg2, rows, ys.empty() ? NULL : &ys[0], arg5);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_classifyDataset(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::dataset *arg2 = 0 ;
+  int arg5 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val5 ;
+  int ecode5 = 0 ;
+  oll_buffer::view idx, out ;
+  const size_t *p = 0 ;
+  size_t n = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOOO:oll_classifyDataset",&obj0,&obj1,&obj2,&obj3,&obj4)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_classifyDataset" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  arg2 = oll_buffer::asDataset(obj1);
+  if (!arg2) SWIG_fail;
+  if (oll_buffer::datasetRows(*arg2, obj2, idx, p, n) == -1) SWIG_fail;
+  if (out.get(obj3, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) == -1) SWIG_fail;
+  if (!oll_buffer::isScores(out.b) || (size_t)out.b.shape[0] != n) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "oll_classifyDataset" "', argument " "4"" of type '" "float32 vector of the row count""'");
+  }
+  ecode5 = SWIG_AsVal_int(obj4, &val5);
+  if (!SWIG_IsOK(ecode5)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode5), "in method '" "oll_classifyDataset" "', argument " "5"" of type '" "int""'");
+  } 
+  arg5 = static_cast< int >(val5);
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    ((oll_tool::oll const *)arg1)->classifyRows(oll_tool::dataset::rows(*arg2, p, n), (float *)out.b.buf, arg5);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  resultobj = SWIG_Py_Void();
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_testDataset(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::dataset *arg2 = 0 ;
+  int arg4 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val4 ;
+  int ecode4 = 0 ;
+  oll_buffer::view idx ;
+  const size_t *p = 0 ;
+  size_t n = 0 ;
+  std::vector<int> ys ;
+  std::vector<int> confMat ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOO:oll_testDataset",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_testDataset" "', argument " "1"" of type '" "oll_tool::oll const *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  arg2 = oll_buffer::asDataset(obj1);
+  if (!arg2) SWIG_fail;
+  if (oll_buffer::datasetRows(*arg2, obj2, idx, p, n) == -1) SWIG_fail;
+  ecode4 = SWIG_AsVal_int(obj3, &val4);
+  if (!SWIG_IsOK(ecode4)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "oll_testDataset" "', argument " "4"" of type '" "int""'");
+  } 
+  arg4 = static_cast< int >(val4);
+  if (use.enter(arg1, oll_buffer::modelUse::READ) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    const oll_tool::dataset::rows rows(*arg2, p, n);
+    rows.labels(ys);
+    ((oll_tool::oll const *)arg1)->testRows(rows, ys.empty() ? NULL : &ys[0], confMat, arg4);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  resultobj = Py_BuildValue("(iiii)", confMat[0], confMat[1], confMat[2], confMat[3]);
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_trainAsync(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  oll_tool::trainMethod arg2 ;
+  int arg5 ;
+  int arg6 ;
+  oll_tool::parallelMethod arg7 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int val2 ;
+  int ecode2 = 0 ;
+  int val5 ;
+  int ecode5 = 0 ;
+  int val6 ;
+  int ecode6 = 0 ;
+  int val7 ;
+  int ecode7 = 0 ;
+  char *buf3 = 0 ;
+  int alloc3 = 0 ;
+  oll_buffer::view idx ;
+  const size_t *p = 0 ;
+  size_t n = 0 ;
+  oll_buffer::asyncTrain *a = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  PyObject * obj5 = 0 ;
+  PyObject * obj6 = 0 ;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OOOOOOO:oll_trainAsync",&obj0,&obj1,&obj2,&obj3,&obj4,&obj5,&obj6)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_trainAsync" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  ecode2 = SWIG_AsVal_int(obj1, &val2);
+  if (!SWIG_IsOK(ecode2)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "oll_trainAsync" "', argument " "2"" of type '" "oll_tool::trainMethod""'");
+  } 
+  arg2 = static_cast< oll_tool::trainMethod >(val2);
+  ecode5 = SWIG_AsVal_int(obj4, &val5);
+  if (!SWIG_IsOK(ecode5)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode5), "in method '" "oll_trainAsync" "', argument " "5"" of type '" "int""'");
+  } 
+  arg5 = static_cast< int >(val5);
+  ecode6 = SWIG_AsVal_int(obj5, &val6);
+  if (!SWIG_IsOK(ecode6)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode6), "in method '" "oll_trainAsync" "', argument " "6"" of type '" "int""'");
+  } 
+  arg6 = static_cast< int >(val6);
+  ecode7 = SWIG_AsVal_int(obj6, &val7);
+  if (!SWIG_IsOK(ecode7)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode7), "in method '" "oll_trainAsync" "', argument " "7"" of type '" "oll_tool::parallelMethod""'");
+  } 
+  arg7 = static_cast< oll_tool::parallelMethod >(val7);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  a = new oll_buffer::asyncTrain();
+  a->ol = arg1;
+  if (PyCapsule_IsValid(obj2, "oll_tool::dataset")) {
+    const oll_tool::dataset *d = oll_buffer::asDataset(obj2);
+    if (oll_buffer::datasetRows(*d, obj3, idx, p, n) == -1) SWIG_fail;
+    const bool all = (p == NULL);
+    const std::vector<size_t> index(p, p + (all ? 0 : n));
+    a->job = new oll_tool::trainJob([=](oll_tool::trainControl &ctl) {
+	const oll_tool::dataset::rows rows(*d, all ? NULL : index.data(), n);
+	std::vector<int> ys;
+	rows.labels(ys);
+	return arg1->trainRows(arg2, rows, ys.empty() ? NULL : &ys[0], arg5, &ctl);
+      });
+  } else {
+    int res3 = SWIG_AsCharPtrAndSize(obj2, &buf3, NULL, &alloc3);
+    if (!SWIG_IsOK(res3)) {
+      SWIG_exception_fail(SWIG_ArgError(res3), "in method '" "oll_trainAsync" "', argument " "3"" of type '" "dataset or char const *""'");
+    }
+    const std::string filename(buf3);
+    a->job = new oll_tool::trainJob([=](oll_tool::trainControl &ctl) {
+	return arg1->trainFile(arg2, filename.c_str(), arg5, false, false, arg6, arg7, &ctl);
+      });
+  }
+  a->refs = Py_BuildValue("(OO)", obj0, obj2);
+  if (alloc3 == SWIG_NEWOBJ) delete[] buf3;
+  return PyCapsule_New(a, "oll_tool::trainJob", oll_buffer::asyncTrain_free);
+fail:
+  delete a;
+  if (alloc3 == SWIG_NEWOBJ) delete[] buf3;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_oll_saveAsync(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::oll *arg1 = (oll_tool::oll *) 0 ;
+  char *arg2 = (char *) 0 ;
+  void *argp1 = 0 ;
+  int res1 = 0 ;
+  int res2 ;
+  char *buf2 = 0 ;
+  int alloc2 = 0 ;
+  oll_buffer::asyncTrain *a = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  
+  oll_buffer::modelUse use ;
+  if (!PyArg_ParseTuple(args,(char *)"OO:oll_saveAsync",&obj0,&obj1)) SWIG_fail;
+  res1 = SWIG_ConvertPtr(obj0, &argp1,SWIGTYPE_p_oll_tool__oll, 0 |  0 );
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "oll_saveAsync" "', argument " "1"" of type '" "oll_tool::oll *""'"); 
+  }
+  arg1 = reinterpret_cast< oll_tool::oll * >(argp1);
+  res2 = SWIG_AsCharPtrAndSize(obj1, &buf2, NULL, &alloc2);
+  if (!SWIG_IsOK(res2)) {
+    SWIG_exception_fail(SWIG_ArgError(res2), "in method '" "oll_saveAsync" "', argument " "2"" of type '" "char const *""'");
+  }
+  arg2 = reinterpret_cast< char * >(buf2);
+  if (use.enter(arg1, oll_buffer::modelUse::WRITE) == -1) SWIG_fail;
+  a = new oll_buffer::asyncTrain();
+  a->ol = arg1;
+  a->detached = true;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    a->job = arg1->saveAsync((char const *)arg2);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  a->refs = Py_BuildValue("(O)", obj0);
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return PyCapsule_New(a, "oll_tool::trainJob", oll_buffer::asyncTrain_free);
+fail:
+  if (alloc2 == SWIG_NEWOBJ) delete[] buf2;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_trainJob_wait(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_buffer::asyncTrain *arg1 = 0 ;
+  double arg2 ;
+  double val2 ;
+  int ecode2 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  bool result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OO:trainJob_wait",&obj0,&obj1)) SWIG_fail;
+  arg1 = oll_buffer::asAsyncTrain(obj0);
+  if (!arg1) SWIG_fail;
+  ecode2 = SWIG_AsVal_double(obj1, &val2);
+  if (!SWIG_IsOK(ecode2)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode2), "in method '" "trainJob_wait" "', argument " "2"" of type '" "double""'");
+  } 
+  arg2 = static_cast< double >(val2);
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = arg1->job->wait(arg2);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  return SWIG_From_bool(result);
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_trainJob_cancel(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_buffer::asyncTrain *arg1 = 0 ;
+  PyObject * obj0 = 0 ;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:trainJob_cancel",&obj0)) return NULL;
+  arg1 = oll_buffer::asAsyncTrain(obj0);
+  if (!arg1) return NULL;
+  arg1->job->control().cancel = true;
+  return SWIG_Py_Void();
+}
+
+
+SWIGINTERN PyObject *_wrap_trainJob_progress(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_buffer::asyncTrain *arg1 = 0 ;
+  PyObject * obj0 = 0 ;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:trainJob_progress",&obj0)) return NULL;
+  arg1 = oll_buffer::asAsyncTrain(obj0);
+  if (!arg1) return NULL;
+  const oll_tool::trainControl &ctl = arg1->job->control();
+  return Py_BuildValue("(NN)", SWIG_From_size_t(ctl.done), SWIG_From_size_t(ctl.total));
+}
+
+
+SWIGINTERN PyObject *_wrap_trainJob_result(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_buffer::asyncTrain *arg1 = 0 ;
+  PyObject * obj0 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:trainJob_result",&obj0)) return NULL;
+  arg1 = oll_buffer::asAsyncTrain(obj0);
+  if (!arg1) return NULL;
+  if (!arg1->job->wait(0)) {
+    PyErr_SetString(PyExc_RuntimeError, "training is still running");
+    return NULL;
+  }
+  result = arg1->job->result();
+  const oll_tool::trainControl &ctl = arg1->job->control();
+  return Py_BuildValue("(iNs)", result,
+		       PyBool_FromLong(result == -1 && ctl.cancel),
+		       ctl.error.empty() ? arg1->ol->getErrorLog().c_str() : ctl.error.c_str());
+}
+
+
+SWIGINTERN PyObject *_wrap_mergeModels(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::modelMerger merger ;
+  char *buf3 = 0 ;
+  int alloc3 = 0 ;
+  int res3 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject *names = 0 ;
+  PyObject *weights = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOO:mergeModels",&obj0,&obj1,&obj2)) SWIG_fail;
+  names = PySequence_Fast(obj0, "filenames must be a sequence");
+  if (!names) SWIG_fail;
+  weights = PySequence_Fast(obj1, "weights must be a sequence");
+  if (!weights) SWIG_fail;
+  if (PySequence_Fast_GET_SIZE(names) != PySequence_Fast_GET_SIZE(weights)) {
+    PyErr_SetString(PyExc_ValueError, "filenames and weights differ in length");
+    SWIG_fail;
+  }
+  for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(names); i++) {
+    char *buf = 0 ;
+    int alloc = 0 ;
+    int res = SWIG_AsCharPtrAndSize(PySequence_Fast_GET_ITEM(names, i), &buf, NULL, &alloc);
+    if (!SWIG_IsOK(res)) {
+      SWIG_exception_fail(SWIG_ArgError(res), "in method '" "mergeModels" "', argument " "1"" of type '" "sequence of char const *""'");
+    }
+    const double weight = PyFloat_AsDouble(PySequence_Fast_GET_ITEM(weights, i));
+    merger.add(buf, (float)weight);
+    if (alloc == SWIG_NEWOBJ) delete[] buf;
+    if (weight == -1.0 && PyErr_Occurred()) SWIG_fail;
+  }
+  res3 = SWIG_AsCharPtrAndSize(obj2, &buf3, NULL, &alloc3);
+  if (!SWIG_IsOK(res3)) {
+    SWIG_exception_fail(SWIG_ArgError(res3), "in method '" "mergeModels" "', argument " "3"" of type '" "char const *""'");
+  }
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = merger.merge((char const *)buf3);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_IOError, merger.getErrorLog().c_str());
+  }
+  Py_DECREF(names);
+  Py_DECREF(weights);
+  if (alloc3 == SWIG_NEWOBJ) delete[] buf3;
+  return SWIG_Py_Void();
+fail:
+  Py_XDECREF(names);
+  Py_XDECREF(weights);
+  if (alloc3 == SWIG_NEWOBJ) delete[] buf3;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_new_mappedModel(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::mappedModel *model = 0 ;
+  char *buf1 = 0 ;
+  int alloc1 = 0 ;
+  int res1 ;
+  PyObject * obj0 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:new_mappedModel",&obj0)) SWIG_fail;
+  res1 = SWIG_AsCharPtrAndSize(obj0, &buf1, NULL, &alloc1);
+  if (!SWIG_IsOK(res1)) {
+    SWIG_exception_fail(SWIG_ArgError(res1), "in method '" "new_mappedModel" "', argument " "1"" of type '" "char const *""'");
+  }
+  model = new oll_tool::mappedModel();
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = model->open((char const *)buf1);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_IOError, model->getErrorLog().c_str());
+  }
+  if (alloc1 == SWIG_NEWOBJ) delete[] buf1;
+  return PyCapsule_New(model, "oll_tool::mappedModel", oll_buffer::mappedModel_free);
+fail:
+  delete model;
+  if (alloc1 == SWIG_NEWOBJ) delete[] buf1;
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_mappedModel_getExampleN(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::mappedModel *arg1 = 0 ;
+  PyObject * obj0 = 0 ;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:mappedModel_getExampleN",&obj0)) return NULL;
+  arg1 = oll_buffer::asMappedModel(obj0);
+  if (!arg1) return NULL;
+  return SWIG_From_size_t(arg1->getExampleN());
+}
+
+
+SWIGINTERN PyObject *_wrap_mappedModel_verify(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::mappedModel *arg1 = 0 ;
+  PyObject * obj0 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"O:mappedModel_verify",&obj0)) return NULL;
+  arg1 = oll_buffer::asMappedModel(obj0);
+  if (!arg1) return NULL;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = arg1->verify();
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  return SWIG_From_int(static_cast< int >(result));
+}
+
+
+SWIGINTERN PyObject *_wrap_mappedModel_classifyExample(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  oll_tool::mappedModel *arg1 = 0 ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  static thread_local oll_tool::fv_t fv ;
+  float result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OO:mappedModel_classifyExample",&obj0,&obj1)) SWIG_fail;
+  arg1 = oll_buffer::asMappedModel(obj0);
+  if (!arg1) SWIG_fail;
+  if (oll_buffer::toFeatureVector(obj1, fv) == -1) SWIG_fail;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = (float)((oll_tool::mappedModel const *)arg1)->classify((oll_tool::fv_t const &)fv);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  return SWIG_From_float(static_cast< float >(result));
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_mappedModel_classifyCSR(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::mappedModel *arg1 = 0 ;
+  int arg6 ;
+  int val6 ;
+  int ecode6 = 0 ;
+  oll_buffer::view indptr, indices, data, out ;
+  oll_buffer::scorer<oll_tool::mappedModel> f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  PyObject * obj4 = 0 ;
+  PyObject * obj5 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOOOOO:mappedModel_classifyCSR",&obj0,&obj1,&obj2,&obj3,&obj4,&obj5)) SWIG_fail;
+  arg1 = oll_buffer::asMappedModel(obj0);
+  if (!arg1) SWIG_fail;
+  if (indptr.get(obj1, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (indices.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (data.get(obj3, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (out.get(obj4, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) == -1) SWIG_fail;
+  if (!oll_buffer::isScores(out.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "mappedModel_classifyCSR" "', argument " "5"" of type '" "float32 vector""'");
+  }
+  ecode6 = SWIG_AsVal_int(obj5, &val6);
+  if (!SWIG_IsOK(ecode6)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode6), "in method '" "mappedModel_classifyCSR" "', argument " "6"" of type '" "int""'");
+  } 
+  arg6 = static_cast< int >(val6);
+  f.ol = arg1;
+  f.out = (float *)out.b.buf;
+  f.outN = (size_t)out.b.shape[0];
+  f.threadN = arg6;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withCSR(indptr.b, indices.b, data.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "mappedModel_classifyCSR" "', malformed CSR buffers or score count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
+SWIGINTERN PyObject *_wrap_mappedModel_classifyDense(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
+  PyObject *resultobj = 0;
+  oll_tool::mappedModel *arg1 = 0 ;
+  int arg4 ;
+  int val4 ;
+  int ecode4 = 0 ;
+  oll_buffer::view x, out ;
+  oll_buffer::scorer<oll_tool::mappedModel> f ;
+  PyObject * obj0 = 0 ;
+  PyObject * obj1 = 0 ;
+  PyObject * obj2 = 0 ;
+  PyObject * obj3 = 0 ;
+  int result;
+  
+  if (!PyArg_ParseTuple(args,(char *)"OOOO:mappedModel_classifyDense",&obj0,&obj1,&obj2,&obj3)) SWIG_fail;
+  arg1 = oll_buffer::asMappedModel(obj0);
+  if (!arg1) SWIG_fail;
+  if (x.get(obj1, PyBUF_STRIDES | PyBUF_FORMAT) == -1) SWIG_fail;
+  if (out.get(obj2, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | PyBUF_WRITABLE) == -1) SWIG_fail;
+  if (!oll_buffer::isScores(out.b)) {
+    SWIG_exception_fail(SWIG_TypeError, "in method '" "mappedModel_classifyDense" "', argument " "3"" of type '" "float32 vector""'");
+  }
+  ecode4 = SWIG_AsVal_int(obj3, &val4);
+  if (!SWIG_IsOK(ecode4)) {
+    SWIG_exception_fail(SWIG_ArgError(ecode4), "in method '" "mappedModel_classifyDense" "', argument " "4"" of type '" "int""'");
+  } 
+  arg4 = static_cast< int >(val4);
+  f.ol = arg1;
+  f.out = (float *)out.b.buf;
+  f.outN = (size_t)out.b.shape[0];
+  f.threadN = arg4;
+  {
+    SWIG_PYTHON_THREAD_BEGIN_ALLOW;
+    result = oll_buffer::withDense(x.b, f);
+    SWIG_PYTHON_THREAD_END_ALLOW;
+  }
+  if (result == -1) {
+    SWIG_exception_fail(SWIG_ValueError, "in method '" "mappedModel_classifyDense" "', malformed matrix buffer or score count");
+  }
+  resultobj = SWIG_From_int(static_cast< int >(result));
+  return resultobj;
+fail:
+  return NULL;
+}
+
+
 SWIGINTERN PyObject *oll_swigregister(PyObject *SWIGUNUSEDPARM(self), PyObject *args) {
   PyObject *obj;
   if (!PyArg_ParseTuple(args,(char*)"O:swigregister", &obj)) return NULL;
@@ -13803,6 +15807,12 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"new_oll", _wrap_new_oll, METH_VARARGS, NULL},
 	 { (char *)"delete_oll", _wrap_delete_oll, METH_VARARGS, NULL},
 	 { (char *)"oll_save", _wrap_oll_save, METH_VARARGS, NULL},
+	 { (char *)"oll_checkpoint", _wrap_oll_checkpoint, METH_VARARGS, NULL},
+	 { (char *)"oll_saveDelta", _wrap_oll_saveDelta, METH_VARARGS, NULL},
+	 { (char *)"oll_loadDelta", _wrap_oll_loadDelta, METH_VARARGS, NULL},
+	 { (char *)"oll_compact", _wrap_oll_compact, METH_VARARGS, NULL},
+	 { (char *)"oll_exportModel", _wrap_oll_exportModel, METH_VARARGS, NULL},
+	 { (char *)"oll_exportHeader", _wrap_oll_exportHeader, METH_VARARGS, NULL},
 	 { (char *)"oll_load", _wrap_oll_load, METH_VARARGS, NULL},
 	 { (char *)"oll_classify", _wrap_oll_classify, METH_VARARGS, NULL},
 	 { (char *)"oll_getMargin", _wrap_oll_getMargin, METH_VARARGS, NULL},
@@ -13813,6 +15823,8 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"oll_parseLine", _wrap_oll_parseLine, METH_VARARGS, NULL},
 	 { (char *)"oll_setC", _wrap_oll_setC, METH_VARARGS, NULL},
 	 { (char *)"oll_setBias", _wrap_oll_setBias, METH_VARARGS, NULL},
+	 { (char *)"oll_getExampleN", _wrap_oll_getExampleN, METH_VARARGS, NULL},
+	 { (char *)"oll_isTrainable", _wrap_oll_isTrainable, METH_VARARGS, NULL},
 	 { (char *)"oll_getErrorLog", _wrap_oll_getErrorLog, METH_VARARGS, NULL},
 	 { (char *)"oll_getResultLog", _wrap_oll_getResultLog, METH_VARARGS, NULL},
 	 { (char *)"oll_trainExampleP", _wrap_oll_trainExampleP, METH_VARARGS, NULL},
@@ -13823,6 +15835,37 @@ static PyMethodDef SwigMethods[] = {
 	 { (char *)"oll_trainExamplePAK", _wrap_oll_trainExamplePAK, METH_VARARGS, NULL},
 	 { (char *)"oll_trainExampleCW", _wrap_oll_trainExampleCW, METH_VARARGS, NULL},
 	 { (char *)"oll_trainExampleAL", _wrap_oll_trainExampleAL, METH_VARARGS, NULL},
+	 { (char *)"oll_trainCSR", _wrap_oll_trainCSR, METH_VARARGS, NULL},
+	 { (char *)"oll_trainDense", _wrap_oll_trainDense, METH_VARARGS, NULL},
+	 { (char *)"oll_classifyCSR", _wrap_oll_classifyCSR, METH_VARARGS, NULL},
+	 { (char *)"oll_classifyDense", _wrap_oll_classifyDense, METH_VARARGS, NULL},
+	 { (char *)"oll_getParam", _wrap_oll_getParam, METH_VARARGS, NULL},
+	 { (char *)"oll_dumps", _wrap_oll_dumps, METH_VARARGS, NULL},
+	 { (char *)"oll_loads", _wrap_oll_loads, METH_VARARGS, NULL},
+	 { (char *)"oll_trainExample", _wrap_oll_trainExample, METH_VARARGS, NULL},
+	 { (char *)"oll_classifyExample", _wrap_oll_classifyExample, METH_VARARGS, NULL},
+	 { (char *)"new_dataset", _wrap_new_dataset, METH_VARARGS, NULL},
+	 { (char *)"dataset_readFile", _wrap_dataset_readFile, METH_VARARGS, NULL},
+	 { (char *)"dataset_appendCSR", _wrap_dataset_appendCSR, METH_VARARGS, NULL},
+	 { (char *)"dataset_appendDense", _wrap_dataset_appendDense, METH_VARARGS, NULL},
+	 { (char *)"dataset_size", _wrap_dataset_size, METH_VARARGS, NULL},
+	 { (char *)"dataset_labels", _wrap_dataset_labels, METH_VARARGS, NULL},
+	 { (char *)"oll_trainDataset", _wrap_oll_trainDataset, METH_VARARGS, NULL},
+	 { (char *)"oll_classifyDataset", _wrap_oll_classifyDataset, METH_VARARGS, NULL},
+	 { (char *)"oll_testDataset", _wrap_oll_testDataset, METH_VARARGS, NULL},
+	 { (char *)"oll_trainAsync", _wrap_oll_trainAsync, METH_VARARGS, NULL},
+	 { (char *)"oll_saveAsync", _wrap_oll_saveAsync, METH_VARARGS, NULL},
+	 { (char *)"trainJob_wait", _wrap_trainJob_wait, METH_VARARGS, NULL},
+	 { (char *)"trainJob_cancel", _wrap_trainJob_cancel, METH_VARARGS, NULL},
+	 { (char *)"trainJob_progress", _wrap_trainJob_progress, METH_VARARGS, NULL},
+	 { (char *)"trainJob_result", _wrap_trainJob_result, METH_VARARGS, NULL},
+	 { (char *)"mergeModels", _wrap_mergeModels, METH_VARARGS, NULL},
+	 { (char *)"new_mappedModel", _wrap_new_mappedModel, METH_VARARGS, NULL},
+	 { (char *)"mappedModel_getExampleN", _wrap_mappedModel_getExampleN, METH_VARARGS, NULL},
+	 { (char *)"mappedModel_verify", _wrap_mappedModel_verify, METH_VARARGS, NULL},
+	 { (char *)"mappedModel_classifyExample", _wrap_mappedModel_classifyExample, METH_VARARGS, NULL},
+	 { (char *)"mappedModel_classifyCSR", _wrap_mappedModel_classifyCSR, METH_VARARGS, NULL},
+	 { (char *)"mappedModel_classifyDense", _wrap_mappedModel_classifyDense, METH_VARARGS, NULL},
 	 { (char *)"oll_swigregister", oll_swigregister, METH_VARARGS, NULL},
 	 { NULL, NULL, 0, NULL }
 };
@@ -14644,6 +16687,17 @@ SWIG_init(void) {
   SWIG_Python_SetConstant(d, "PAK",SWIG_From_int(static_cast< int >(oll_tool::PAK)));
   SWIG_Python_SetConstant(d, "CW",SWIG_From_int(static_cast< int >(oll_tool::CW)));
   SWIG_Python_SetConstant(d, "AL",SWIG_From_int(static_cast< int >(oll_tool::AL)));
+  SWIG_Python_SetConstant(d, "HOGWILD",SWIG_From_int(static_cast< int >(oll_tool::HOGWILD)));
+  SWIG_Python_SetConstant(d, "MIX",SWIG_From_int(static_cast< int >(oll_tool::MIX)));
+  SWIG_Python_SetConstant(d, "TRAINING",SWIG_From_int(static_cast< int >(oll_tool::TRAINING)));
+  SWIG_Python_SetConstant(d, "INFERENCE",SWIG_From_int(static_cast< int >(oll_tool::INFERENCE)));
+  SWIG_Python_SetConstant(d, "FLOAT32",SWIG_From_int(static_cast< int >(oll_tool::FLOAT32)));
+  SWIG_Python_SetConstant(d, "FLOAT16",SWIG_From_int(static_cast< int >(oll_tool::FLOAT16)));
+  SWIG_Python_SetConstant(d, "INT8",SWIG_From_int(static_cast< int >(oll_tool::INT8)));
+  SWIG_Python_SetConstant(d, "BFLOAT16",SWIG_From_int(static_cast< int >(oll_tool::BFLOAT16)));
+  
+  /* Initialize threading */
+  SWIG_PYTHON_INITIALIZE_THREADS;
 #if PY_VERSION_HEX >= 0x03000000
   return m;
 #else
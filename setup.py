@@ -11,9 +11,9 @@ with open(os.path.join('oll', '__init__.py'), 'r', encoding='utf8') as f:
 
 oll_module = Extension(
     '_oll',
-    sources=['lib/oll.cpp', 'oll_swig_wrap.cxx'],
+    sources=['lib/oll.cpp', 'lib/oll_c.cpp', 'oll_swig_wrap.cxx'],
     include_dirs=['lib'],
-    depends=['lib/oll.hpp'],
+    depends=['lib/oll.hpp', 'lib/oll_c.h'],
     language='c++'
 )
 
@@ -28,7 +28,7 @@ setup(
                                    open('CHANGES.rst', encoding='utf8').read()),
     ext_modules=[oll_module],
     py_modules=["oll"],
-    headers=['lib/oll.hpp'],
+    headers=['lib/oll.hpp', 'lib/oll_c.h'],
     packages=['oll'],
     classifiers=[
         'Development Status :: 3 - Alpha',
@@ -1,10 +1,16 @@
 # -*- coding: utf-8 -*-
 import os
+import pickle
+import shutil
+import struct
 import tempfile
+import threading
+import time
 from nose.tools import ok_, eq_, assert_raises, assert_almost_equals
 import numpy as np
 from scipy.sparse import csr_matrix
 import oll
+from oll.oll import _oll, CancelledError, TimeoutError
 
 
 class Test_oll(object):
@@ -32,6 +38,35 @@ class Test_oll(object):
         self.oll.add({0: -0.5, 1: 1.0, 2: -0.5}, -1)
         assert_almost_equals(self.oll.classify({0: 1.0, 1: 1.0}), 0.171429, 6)
 
+    def test_example_types(self):
+        import array
+        for algorithm in ('P', 'AP', 'PA1', 'PAK', 'CW'):
+            (a, b) = (oll.oll(algorithm), oll.oll(algorithm))
+            examples = [({0: 1.0, 3: 2.0, 7: -1.0}, 1),
+                        ({1: -0.5, 3: 1.0}, -1), ({0: 0.25, 7: 2}, 1)]
+            for (i, (x, y)) in enumerate(examples):
+                a.add(x, y)
+                (ids, values) = (list(x.keys()), list(x.values()))
+                pair = ((ids, values),
+                        (array.array('i', ids), array.array('d', values)),
+                        (np.array(ids), np.array(values, dtype=np.float32)),
+                        (tuple(ids), array.array('f', values)))[i % 4]
+                b.add(pair, np.int64(y))
+            for x in ({0: 1.0, 7: 0.5}, {}, {100: 1.0}):
+                (ids, values) = (list(x.keys()), list(x.values()))
+                desired = a.classify(x)
+                eq_(b.classify(x), desired)
+                eq_(b.classify((ids, values)), desired)
+                eq_(b.classify((np.array(ids, dtype=np.int64),
+                                array.array('d', values))), desired)
+        assert_raises(ValueError, self.oll.classify, ([0, 1], [1.0]))
+        assert_raises(ValueError, self.oll.add,
+                      (array.array('i', [0]), np.zeros(2)), 1)
+        assert_raises(TypeError, self.oll.classify, [(0, 1.0)])
+        assert_raises(TypeError, self.oll.classify, {0: 'a'})
+        assert_raises(NotImplementedError, self.oll.classify, ([0.5], [1.0]))
+        assert_raises(OverflowError, self.oll.add, {2 ** 40: 1.0}, 1)
+
     def test_save_and_load(self):
         try:
             self.oll = oll.oll('PA1')
@@ -46,6 +81,338 @@ class Test_oll(object):
         finally:
             os.remove(filename)
 
+    def test_dumps_and_loads(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(60, 5) * (rng.rand(60, 5) > 0.3)
+        y = np.where(X.sum(axis=1) > 0, 1, -1)
+        filename = tempfile.mkstemp()[1]
+        try:
+            for algorithm in ('P', 'AP', 'PA', 'PA1', 'PA2', 'PAK', 'CW',
+                              'AL'):
+                o = oll.oll(algorithm, C=0.5, bias=0.3).fit(X, y)
+                data = o.dumps()
+                ok_(isinstance(data, bytes))
+                o.save(filename)
+                with open(filename, 'rb') as fd:
+                    eq_(fd.read(), data)
+
+                desired = o.decision_function(X)
+                for copied in (pickle.loads(pickle.dumps(o)),
+                               pickle.loads(pickle.dumps(o, 2))):
+                    eq_(copied.algorithm, algorithm)
+                    eq_(copied.get_params(), {'C': 0.5, 'bias': 0.3})
+                    np.testing.assert_array_equal(
+                        copied.decision_function(X), desired)
+                    eq_(copied.dumps(), data)
+
+                del o  # the bytes are all a model needs
+                loaded = oll.oll(algorithm)
+                eq_(loaded.loads(bytearray(data)), 0)
+                np.testing.assert_array_equal(
+                    loaded.decision_function(X), desired)
+                eq_(loaded.loads(memoryview(data)[:-1]), -1)
+        finally:
+            os.remove(filename)
+        state = oll.oll('P').__getstate__()
+        state['model'] = state['model'][:-1]
+        assert_raises(ValueError, oll.oll.__new__(oll.oll).__setstate__,
+                      state)
+
+    def test_sparse_model_file(self):
+        # a few features with ids up to 10**6: w, w0, wa and cov are saved
+        # as their touched entries only
+        examples = [({1: 1.0, 10 ** 6: 0.5}, 1), ({2: -1.0, 500: 1.0}, -1),
+                    ({1: 0.5, 2: 0.5}, 1)]
+        filename = tempfile.mkstemp()[1]
+        try:
+            for algorithm in ('AP', 'CW'):
+                o = oll.oll(algorithm)
+                for x, y in examples:
+                    o.add(x, y)
+                data = o.dumps()
+                ok_(len(data) < 10000)
+                loaded = oll.oll(algorithm)
+                eq_(loaded.loads(data), 0)
+                o.save(filename)
+                mapped = oll.MappedModel(filename)
+                for x in [{1: 1.0}, {10 ** 6: 2.0, 3: 1.0}, {500: -1.0},
+                          {10 ** 7: 1.0}]:
+                    eq_(loaded.classify(x), o.classify(x))
+                    eq_(mapped.classify(x), o.classify(x))
+                eq_(loaded.dumps(), data)
+        finally:
+            os.remove(filename)
+
+    def test_load_mode_and_checksums(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(50, 8)
+        y = np.where(X.sum(axis=1) > 0, 1, -1)
+        for algorithm in ('AP', 'PAK', 'CW'):
+            o = oll.oll(algorithm).fit(X, y)
+            data = o.dumps()
+            loaded = oll.oll(algorithm)
+            eq_(loaded.loads(data, oll.INFERENCE), 0)
+            np.testing.assert_array_equal(loaded.decision_function(X),
+                                          o.decision_function(X))
+            assert_raises(RuntimeError, loaded.add, {0: 1.0}, 1)
+            assert_raises(RuntimeError, loaded.fit, X, y)
+            eq_(loaded.loads(data), 0)
+            loaded.add({0: 1.0}, 1)
+
+        # a flipped bit anywhere is caught by the checksums, and the model
+        # is left as it was
+        o = oll.oll('CW').fit(X, y)
+        data = o.dumps()
+        sections = dict((data[i:i + 8].rstrip(b'\0'),
+                         struct.unpack_from('=Q', data, i + 8)[0])
+                        for i in range(80, 80 + 48 * struct.unpack_from(
+                            '=I', data, 20)[0], 48))
+        filename = tempfile.mkstemp()[1]
+        try:
+            for pos in (20, 450, sections[b'cov']):  # header, w, cov
+                broken = bytearray(data)
+                broken[pos] ^= 0x10
+                eq_(o.loads(bytes(broken)), -1)
+                eq_(o.dumps(), data)
+                with open(filename, 'wb') as fd:
+                    fd.write(broken)
+                if pos < 80:
+                    assert_raises(IOError, oll.MappedModel, filename)
+                else:
+                    eq_(oll.MappedModel(filename).verify(), -1)
+            with open(filename, 'wb') as fd:
+                fd.write(data)
+            eq_(oll.MappedModel(filename).verify(), 0)
+            o.add({0: 1.0}, 1)  # still trainable
+        finally:
+            os.remove(filename)
+
+    def test_delta_checkpoints(self):
+        rng = np.random.RandomState(0)
+        X = csr_matrix(rng.randn(300, 40000) * (rng.rand(300, 40000) > 0.99))
+        y = np.where(rng.rand(300) > 0.5, 1, -1)
+        X_new = csr_matrix((np.ones(4), ([0, 1, 2, 3], [5, 6, 7, 39999])),
+                           shape=(4, 40000))
+        tmpdir = tempfile.mkdtemp()
+        path = lambda name: os.path.join(tmpdir, name)
+        try:
+            for algorithm in ('AP', 'PAK', 'CW'):
+                o = oll.oll(algorithm).fit(X, y)
+                eq_(o.save_delta(path('none')), -1)  # no checkpoint yet
+                eq_(o.checkpoint(path('base')), 0)
+                o.partial_fit(X_new[:2], [1, -1])
+                eq_(o.save_delta(path('1')), 0)
+                o.partial_fit(X_new[2:], [1, -1])
+                eq_(o.save_delta(path('2')), 0)
+                if algorithm != 'PAK':
+                    ok_(os.path.getsize(path('1')) * 4 <
+                        os.path.getsize(path('base')))
+
+                replica = oll.oll(algorithm)
+                eq_(replica.load(path('base')), 0)
+                eq_(replica.load_delta(path('2')), -1)  # out of order
+                eq_(replica.load_delta(path('1')), 0)
+                eq_(replica.load_delta(path('2')), 0)
+                eq_(replica.dumps(), o.dumps())
+
+                # base and the first delta compacted, the second replayed
+                compacted = oll.oll(algorithm)
+                compacted.load(path('base'))
+                compacted.load_delta(path('1'))
+                eq_(compacted.compact(path('compacted')), 0)
+                replica = oll.oll(algorithm)
+                eq_(replica.load(path('compacted')), 0)
+                eq_(replica.load_delta(path('2')), 0)
+                eq_(replica.dumps(), o.dumps())
+                compacted.add({0: 1.0}, 1)
+                eq_(compacted.compact(path('compacted')), -1)
+        finally:
+            shutil.rmtree(tmpdir)
+
+    def test_mapped_model(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(100, 6) * (rng.rand(100, 6) > 0.3)
+        y = np.where(X.sum(axis=1) > 0, 1, -1)
+        filename = tempfile.mkstemp()[1]
+        try:
+            for algorithm in ('P', 'AP', 'PA', 'PA1', 'PA2', 'PAK', 'CW',
+                              'AL'):
+                o = oll.oll(algorithm, bias=0.5).fit(X, y)
+                o.save(filename)
+                mapped = oll.MappedModel(filename)
+                eq_(mapped.example_count, _oll.oll_getExampleN(o))
+                desired = o.decision_function(X)
+                for X_ in (X, csr_matrix(X)):
+                    np.testing.assert_array_equal(
+                        mapped.decision_function(X_, n_jobs=2), desired)
+                eq_(mapped.classify({0: 1.0, 3: -0.5, 100: 2.0}),
+                    o.classify({0: 1.0, 3: -0.5, 100: 2.0}))
+                np.testing.assert_array_equal(mapped.predict(X),
+                                              o.predict(X))
+
+            # models in the original oll format still load
+            legacy = struct.pack('=QQQff', 2, 0, 1, 1.0, 0.0)
+            legacy += struct.pack('=Q2f', 2, 0.5, -1.0) + struct.pack('=f', 0.25)
+            for _ in ('w0', 'wa', 'cov'):
+                legacy += struct.pack('=Qf', 0, 0.0)
+            legacy += struct.pack('=QQ', 0, 0)
+            o = oll.oll('P')
+            eq_(o.loads(legacy), 0)
+            assert_almost_equals(o.classify({0: 2.0, 1: 1.0}), 0.25)
+            with open(filename, 'wb') as fd:
+                fd.write(legacy)
+            assert_raises(IOError, oll.MappedModel, filename)
+            o.save(filename)
+            assert_almost_equals(
+                oll.MappedModel(filename).classify({0: 2.0, 1: 1.0}), 0.25)
+        finally:
+            os.remove(filename)
+        assert_raises(IOError, oll.MappedModel, filename)
+
+    def test_export(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(200, 300)
+        y = np.where(X[:, :10].sum(axis=1) > 0, 1, -1)
+        filename = tempfile.mkstemp()[1]
+        try:
+            for algorithm in ('P', 'AP', 'CW'):
+                o = oll.oll(algorithm, bias=0.5).fit(X, y)
+                desired = o.decision_function(X)
+                sizes = []
+                for (precision, tolerance) in ((oll.FLOAT32, 1e-4),
+                                               (oll.FLOAT16, 1e-2),
+                                               (oll.INT8, 0.2),
+                                               (oll.BFLOAT16, 5e-2)):
+                    eq_(o.export(filename, precision), 0)
+                    sizes.append(os.path.getsize(filename))
+                    mapped = oll.MappedModel(filename)
+                    eq_(mapped.verify(), 0)
+                    scores = mapped.decision_function(X)
+                    ok_(np.abs(scores - desired).max() <
+                        tolerance * np.abs(desired).max())
+                    loaded = oll.oll(algorithm)
+                    eq_(loaded.load(filename), 0)
+                    np.testing.assert_array_equal(
+                        loaded.decision_function(X), scores)
+                    assert_raises(RuntimeError, loaded.add, {0: 1.0}, 1)
+                ok_(sizes[1] < sizes[0] * 0.6 and sizes[2] < sizes[0] * 0.4)
+                eq_(sizes[3], sizes[1])
+            eq_(oll.oll('PAK').fit(X, y).export(filename), -1)
+        finally:
+            os.remove(filename)
+
+    def test_merge(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(300, 50) * (rng.rand(300, 50) > 0.5)
+        y = np.where(X[:, :10].sum(axis=1) > 0, 1, -1)
+        tmpdir = tempfile.mkdtemp()
+        path = lambda name: os.path.join(tmpdir, name)
+        try:
+            for algorithm in ('P', 'AP', 'PA1', 'CW'):
+                shards = [oll.oll(algorithm, bias=1.0).fit(X[:100], y[:100]),
+                          oll.oll(algorithm, bias=1.0).fit(X[100:], y[100:])]
+                for (i, o) in enumerate(shards):
+                    o.save(path('%d' % i))
+                merged = oll.oll(algorithm)
+                if algorithm != 'CW':  # CW does not count examples
+                    oll.merge([path('0'), path('1')], path('merged'))
+                    eq_(merged.load(path('merged')), 0)
+                    eq_(_oll.oll_getExampleN(merged), 300)
+                    desired = (shards[0].decision_function(X) +
+                               2 * shards[1].decision_function(X)) / 3
+                    np.testing.assert_allclose(
+                        merged.decision_function(X), desired, atol=1e-4)
+                # a model merged with itself stays as it was
+                oll.merge([path('1'), path('1')], path('merged'), [1, 3])
+                merged.load(path('merged'))
+                np.testing.assert_allclose(merged.decision_function(X),
+                                           shards[1].decision_function(X),
+                                           atol=1e-4)
+                merged.fit(X, y)  # and can be trained further
+
+            oll.oll('P').fit(X, y).save(path('P'))
+            oll.oll('PAK').fit(X[:20], y[:20]).save(path('PAK'))
+            assert_raises(IOError, oll.merge, [path('P'), path('1')],
+                          path('merged'))
+            assert_raises(IOError, oll.merge, [path('PAK')], path('merged'))
+            assert_raises(IOError, oll.merge, [path('missing')],
+                          path('merged'))
+            assert_raises(ValueError, oll.merge, [path('P')], path('merged'),
+                          [1, 2])
+        finally:
+            shutil.rmtree(tmpdir)
+
+    def test_export_header(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(50, 20).astype(np.float32)
+        y = np.where(X[:, :5].sum(axis=1) > 0, 1, -1)
+        tmpdir = tempfile.mkdtemp()
+        path = lambda name: os.path.join(tmpdir, name)
+        try:
+            o = oll.oll('AP', bias=0.5).fit(X, y)
+            eq_(o.export_header(path('model.hpp'), 'spam'), 0)
+            with open(path('model.hpp')) as f:
+                header = f.read()
+            ok_('namespace spam{' in header)
+            ok_('constexpr std::size_t featureN = 20;' in header)
+            eq_(o.export_header(path('bad.hpp'), '1spam'), -1)
+            zero = oll.oll('P')
+            zero.add({19: 0.0}, 1)  # weights of 20 features, all 0
+            eq_(zero.export_header(path('zero.hpp'), 'zero'), 0)
+            with open(path('zero.hpp')) as f:
+                header = f.read()
+            ok_('constexpr std::size_t featureN = 0;' in header)
+            ok_('weightN' not in header)
+            eq_(oll.oll('PAK').fit(X, y).export_header(path('pak.hpp'),
+                                                       'spam'), -1)
+            compiler = shutil.which('c++')
+            if compiler is None:
+                return
+            rows = ',\n'.join('{%s}' % ', '.join('%.9gf' % v for v in row)
+                               for row in X)
+            with open(path('main.cpp'), 'w') as f:
+                f.write('#include <cstdio>\n#include "model.hpp"\n'
+                        'const float X[][20] = {%s};\n'
+                        'int main(){\n'
+                        '  for (const float* x : X) '
+                        'printf("%%.9g\\n", spam::score(x, 20));\n'
+                        '}\n' % rows)
+            eq_(os.system('%s -std=c++11 -pedantic-errors -o %s %s' % (
+                compiler, path('main'), path('main.cpp'))), 0)
+            with open(path('zero.cpp'), 'w') as f:
+                f.write('#include "zero.hpp"\n'
+                        'int main(){ const float x[1] = {1.f};'
+                        ' return zero::score(x, 1) != 0.f; }\n')
+            eq_(os.system('%s -std=c++11 -pedantic-errors -o %s %s' % (
+                compiler, path('zero'), path('zero.cpp'))), 0)
+            eq_(os.system(path('zero')), 0)
+            scores = np.array(os.popen(path('main')).read().split(), float)
+            np.testing.assert_allclose(scores, o.decision_function(X),
+                                       rtol=1e-5, atol=1e-5)
+        finally:
+            shutil.rmtree(tmpdir)
+
+    def test_c_interface(self):
+        cxx, cc = shutil.which('g++'), shutil.which('cc')
+        if cxx is None or cc is None:
+            return
+        here = os.path.dirname(os.path.abspath(__file__))
+        lib = os.path.join(here, 'lib')
+        tmpdir = tempfile.mkdtemp()
+        path = lambda name: os.path.join(tmpdir, name)
+        try:
+            # the commands of lib/oll_c.h and test_oll_c.c
+            eq_(os.system('%s -O2 -shared -fPIC -I%s %s %s -o %s -pthread' % (
+                cxx, lib, os.path.join(lib, 'oll_c.cpp'),
+                os.path.join(lib, 'oll.cpp'), path('liboll.so'))), 0)
+            eq_(os.system('%s -std=c99 -pedantic-errors -I%s %s -o %s -L%s '
+                          '-loll' % (cc, lib, os.path.join(here, 'test_oll_c.c'),
+                                     path('test_oll_c'), tmpdir)), 0)
+            eq_(os.system('LD_LIBRARY_PATH=%s %s' % (
+                tmpdir, path('test_oll_c'))), 0)
+        finally:
+            shutil.rmtree(tmpdir)
+
     def test_testFile(self):
         try:
             self.oll = oll.oll('PA1')
@@ -90,9 +457,14 @@ class Test_oll(object):
         np_array = np.array([[1.0, 2.0, -1.0], [-0.5, 1.0, -0.5]])
         y = [1, -1]
         self.oll.fit(np_array, y)
-        print(self.oll.decision_function(np_array))
-        assert_almost_equals(self.oll.decision_function(np_array),
-                [-0.17142848670482635, -0.48571422696113586], 6) 
+        scores = self.oll.decision_function(np_array)
+        eq_(scores.dtype, np.float32)
+        np.testing.assert_almost_equal(
+            scores, [-0.17142848670482635, -0.48571422696113586], 6)
+        np.testing.assert_array_equal(
+            self.oll.decision_function(csr_matrix(np_array)), scores)
+        np.testing.assert_array_equal(
+            self.oll.decision_function(np_array.astype(np.float32)), scores)
 
     def test_fit(self):
         np_array = np.array([[1.0, 2.0, -1.0], [-0.5, 1.0, -0.5]])
@@ -110,11 +482,471 @@ class Test_oll(object):
 
         assert_raises(AssertionError, self.oll.fit, np_array, [1, 0])
 
+    def test_fit_buffers(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(40, 6) * (rng.rand(40, 6) > 0.5)
+        y = np.where(rng.rand(40) > 0.5, 1, -1)
+        probe = {0: 1.0, 2: -0.5, 5: 2.0}
+        wide = np.zeros((40, 12))
+        wide[:, ::2] = X
+        for algorithm in ('P', 'AP', 'PA', 'PA1', 'PA2', 'PAK', 'CW', 'AL'):
+            desired = oll.oll(algorithm)
+            for (x, y_i) in zip(X, y):
+                desired.add(dict((i, v) for (i, v) in enumerate(x) if v),
+                            int(y_i))
+            desired = desired.classify(probe)
+            for X_ in (X, X.astype(np.float32), np.asfortranarray(X),
+                       wide[:, ::2],
+                       csr_matrix(X), csr_matrix(X, dtype=np.float32)):
+                o = oll.oll(algorithm).fit(X_, y)
+                assert_almost_equals(o.classify(probe), desired, 5)
+        sparse_matrix = csr_matrix(X)
+        sparse_matrix.indptr = sparse_matrix.indptr.astype(np.int64)
+        sparse_matrix.indices = sparse_matrix.indices.astype(np.int64)
+        o = oll.oll('PA1').fit(sparse_matrix, y)
+        eq_(o.classify(probe), oll.oll('PA1').fit(X, y).classify(probe))
+        o = oll.oll('PA1').fit(X[::-1], list(y[::-1]))
+        eq_(o.classify(probe), oll.oll('PA1').fit(
+            np.ascontiguousarray(X[::-1]), y[::-1]).classify(probe))
+        eq_(oll.oll('PA1').fit(np.array([[1, 2, -1], [0, 0, 1]]), [1, -1])
+            .classify(probe),
+            oll.oll('PA1').fit(np.array([[1., 2., -1.], [0., 0., 1.]]),
+                               [1, -1]).classify(probe))
+        assert_raises(ValueError, oll.oll('PA1').fit, X, y[:-1])
+        assert_raises(ValueError, oll.oll('PA1').fit, csr_matrix(X), y[:-1])
+
+    def test_partial_fit(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(100, 5) * (rng.rand(100, 5) > 0.3)
+        y = np.where(X.sum(axis=1) > 0, 1, -1)
+        probe = {0: 1.0, 3: -1.0}
+        for algorithm in ('P', 'AP', 'PA1', 'PAK', 'CW'):
+            desired = oll.oll(algorithm).fit(X, y).classify(probe)
+            for X_ in (X, csr_matrix(X)):
+                o = oll.oll(algorithm)
+                for begin in range(0, 100, 30):
+                    ok_(o.partial_fit(X_[begin:begin + 30],
+                                      y[begin:begin + 30],
+                                      classes=[-1, 1]) is o)
+                eq_(o.classify(probe), desired)
+        assert_raises(AssertionError, oll.oll('PA1').partial_fit, X, y,
+                      classes=[0, 1])
+        assert_raises(AssertionError, oll.oll('PA1').partial_fit, X[:2],
+                      [1, 0])
+
+    def test_coef_(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(50, 6)
+        y = np.where(X[:, 0] > 0, 1, -1)
+        probe = np.array([1.0, 0.5, 0.0, -1.0, 0.0, 2.0])
+        for algorithm in ('P', 'AP', 'PA', 'PA1', 'PA2', 'CW', 'AL'):
+            o = oll.oll(algorithm, bias=1.0).fit(X, y)
+            (coef, intercept) = (o.coef_, o.intercept_)
+            eq_(coef.shape, (1, 6))
+            eq_(intercept.shape, (1,))
+            assert_almost_equals(
+                float(coef.dot(probe)[0] + intercept[0]),
+                o.classify(dict(enumerate(probe))), 4)
+            del coef, intercept
+        ok_(not o.coef_.flags.writeable)
+        assert_raises(ValueError, o.coef_.__setitem__, (0, 0), 1.0)
+        assert_raises(AttributeError, getattr, o, 'cov_')
+        assert_raises(AttributeError, getattr, oll.oll('PAK'), 'coef_')
+        eq_(oll.oll('P').coef_.shape, (1, 0))
+
+        o = oll.oll('CW').fit(X, y)
+        cov = o.cov_
+        eq_(cov.shape, (1, 6))
+        ok_(np.all((cov > 0) & (cov <= 1)))
+
+        # the arrays share the storage of the model, which must not grow
+        # under them
+        coef = o.coef_
+        ok_(np.shares_memory(coef, o.coef_))
+        assert_raises(BufferError, o.add, {10: 1.0}, 1)
+        assert_raises(BufferError, o.fit, X, y)
+        del cov
+        assert_raises(BufferError, o.partial_fit, X, y)
+        del coef
+        o.add({10: 1.0}, 1)
+        eq_(o.coef_.shape, (1, 11))
+
     def test_predict(self):
         self.oll.add({0: 1.0, 1: 2.0, 2: -1.0}, 1)
         self.oll.add({0: -0.5, 1: 1.0, 2: -0.5}, -1)
         np_array = np.array([[1.0, 1.0]])
-        eq_(self.oll.predict(np_array), [1])
+        np.testing.assert_array_equal(self.oll.predict(np_array), [1])
 
         sparse_matrix = csr_matrix([[1.0, 1.0]])
-        eq_(self.oll.predict(sparse_matrix), [1])
+        np.testing.assert_array_equal(self.oll.predict(sparse_matrix), [1])
+
+    def test_decision_function_rows(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(300, 8) * (rng.rand(300, 8) > 0.4)
+        y = np.where(X.sum(axis=1) > 0, 1, -1)
+        for algorithm in ('P', 'AP', 'PA', 'PA1', 'PA2', 'PAK', 'CW', 'AL'):
+            o = oll.oll(algorithm).fit(X, y)
+            desired = np.array([
+                o.classify(dict((i, v) for (i, v) in enumerate(x) if v))
+                for x in X], dtype=np.float32)
+            for n_jobs in (1, 4):
+                for X_ in (X, np.asfortranarray(X), csr_matrix(X)):
+                    np.testing.assert_array_equal(
+                        o.decision_function(X_, n_jobs=n_jobs), desired)
+            np.testing.assert_array_equal(
+                o.predict(csr_matrix(X), n_jobs=3),
+                np.where(desired > 0, 1, -1))
+        eq_(len(o.decision_function(np.zeros((0, 8)))), 0)
+
+    def test_dataset(self):
+        rng = np.random.RandomState(0)
+        X = rng.randn(200, 8) * (rng.rand(200, 8) > 0.4)
+        y = np.where(X.sum(axis=1) > 0, 1, -1)
+        try:
+            filename = tempfile.mkstemp()[1]
+            with open(filename, 'w') as fd:
+                for (x, label) in zip(X, y):
+                    fd.write('%+d %s\n' % (label, ' '.join(
+                        '%d:%.17g' % (i, v) for (i, v) in enumerate(x) if v)))
+            datasets = [oll.Dataset(filename), oll.Dataset(X, y),
+                        oll.Dataset(csr_matrix(X), y)]
+        finally:
+            os.remove(filename)
+        assert_raises(IOError, oll.Dataset, filename)
+        for algorithm in ('P', 'AP', 'PA1', 'CW'):
+            desired = oll.oll(algorithm).fit(X, y)
+            scores = desired.decision_function(X)
+            for data in datasets:
+                eq_(len(data), len(y))
+                np.testing.assert_array_equal(data.labels, y)
+                o = oll.oll(algorithm).fit(data)
+                np.testing.assert_array_equal(o.decision_function(data),
+                                              scores)
+                np.testing.assert_array_equal(o.predict(data, n_jobs=2),
+                                              np.where(scores > 0, 1, -1))
+                eq_(o.evaluate(data), desired.evaluate(X, y))
+
+        # folds share the parsed examples, and index composes
+        data = datasets[0]
+        (train, test) = (data[::2], data[np.arange(1, len(y), 2)])
+        o = oll.oll('PA1').fit(train)
+        desired = oll.oll('PA1').fit(X[::2], y[::2])
+        np.testing.assert_array_equal(o.decision_function(test),
+                                      desired.decision_function(X[1::2]))
+        np.testing.assert_array_equal(test[[0, -1]].labels, y[[1, -1]])
+        np.testing.assert_array_equal(data[y > 0].labels, y[y > 0])
+        eq_(len(data[[]]), 0)
+        assert_raises(IndexError, data.__getitem__, [len(y)])
+        assert_raises(ValueError, o.fit, data, y)
+
+        conf = o.evaluate(X, y)
+        eq_(sum(conf[k] for k in ('true-positive', 'false-negative',
+                                  'false-positive', 'true-negative')),
+            len(y))
+
+
+class Test_threads(object):
+    """
+    trainFile, testFile, classify and add release the GIL, so these run the
+    same calls from several Python threads at once and compare the results
+    with a serial run.
+    """
+
+    n_threads = 8
+
+    def setUp(self):
+        rng = np.random.RandomState(0)
+        w = rng.randn(20)
+        self.examples = []
+        for _ in range(500):
+            x = dict((int(i), float(rng.randn()))
+                     for i in rng.choice(20, 5, replace=False))
+            y = 1 if sum(w[i] * v for (i, v) in x.items()) > 0 else -1
+            self.examples.append((x, y))
+        self.train_filename = tempfile.mkstemp()[1]
+        with open(self.train_filename, 'w') as fd:
+            for (x, y) in self.examples:
+                fd.write('%+d %s\n' % (y, ' '.join(
+                    '%d:%f' % (i, v) for (i, v) in sorted(x.items()))))
+
+    def tearDown(self):
+        os.remove(self.train_filename)
+
+    def _run(self, target, n=None):
+        n = n or self.n_threads
+        results = [None] * n
+        errors = []
+
+        def run(i):
+            try:
+                results[i] = target(i)
+            except Exception as e:
+                errors.append(e)
+        threads = [threading.Thread(target=run, args=(i,)) for i in range(n)]
+        for t in threads:
+            t.start()
+        for t in threads:
+            t.join()
+        eq_(errors, [])
+        return results
+
+    def _train(self, algorithm):
+        o = oll.oll(algorithm)
+        for (x, y) in self.examples:
+            o.add(x, y)
+        return o
+
+    def test_add(self):
+        algorithms = ('P', 'AP', 'PA', 'PA1', 'PA2', 'PAK', 'CW', 'AL')
+        xs = [x for (x, _) in self.examples[:50]]
+        def target(i):
+            o = self._train(algorithms[i])
+            return [o.classify(x) for x in xs]
+        desired = [target(i) for i in range(len(algorithms))]
+        actual = self._run(target, len(algorithms))
+        eq_(actual, desired)
+
+    def test_fit(self):
+        X = csr_matrix(np.array([[x.get(i, 0.0) for i in range(20)]
+                                 for (x, _) in self.examples]))
+        y = [y for (_, y) in self.examples]
+        probe = self.examples[0][0]
+        desired = oll.oll('CW').fit(X, y).classify(probe)
+        actual = self._run(lambda i: oll.oll('CW').fit(X, y).classify(probe))
+        eq_(actual, [desired] * self.n_threads)
+
+    def test_classify(self):
+        o = self._train('CW')
+        desired = [o.classify(x) for (x, _) in self.examples]
+        actual = self._run(
+            lambda i: [o.classify(x) for (x, _) in self.examples])
+        for scores in actual:
+            eq_(scores, desired)
+
+    def test_same_model_from_threads(self):
+        # training overlapping any other call on its model raises, in
+        # whichever thread comes second
+        rng = np.random.RandomState(0)
+        X = csr_matrix(rng.randn(2000, 2000) * (rng.rand(2000, 2000) > 0.9))
+        y = np.where(rng.rand(2000) > 0.5, 1, -1)
+        o = oll.oll('CW')
+        errors = []
+        started = threading.Event()
+
+        def fit():
+            started.set()
+            for _ in range(20):
+                try:
+                    o.partial_fit(X, y)
+                except RuntimeError as e:
+                    errors.append(e)
+        t = threading.Thread(target=fit)
+        t.start()
+        started.wait()
+        while t.is_alive():
+            for call in (lambda: o.classify({0: 1.0}),
+                         lambda: o.add({0: 1.0}, 1)):
+                try:
+                    call()
+                except RuntimeError as e:
+                    errors.append(e)
+        t.join()
+        ok_(len(errors) > 0)
+        o.add({0: 1.0}, 1)
+        o.classify({0: 1.0})
+
+    def test_classify_while_training(self):
+        trained = self._train('PA1')
+        scored = self._train('PA1')
+        desired = [scored.classify(x) for (x, _) in self.examples]
+
+        def target(i):
+            if i == 0:
+                return self._train('PA1').classify(self.examples[0][0])
+            return [scored.classify(x) for (x, _) in self.examples]
+        actual = self._run(target)
+        eq_(actual[0], trained.classify(self.examples[0][0]))
+        for scores in actual[1:]:
+            eq_(scores, desired)
+
+    def test_decision_function(self):
+        o = self._train('PAK')
+        X = csr_matrix(np.array([[x.get(i, 0.0) for i in range(20)]
+                                 for (x, _) in self.examples]))
+        desired = o.decision_function(X)
+        actual = self._run(lambda i: o.decision_function(X, n_jobs=2))
+        for scores in actual:
+            np.testing.assert_array_equal(scores, desired)
+
+    def test_testFile(self):
+        o = self._train('PA1')
+        desired = o.testFile(self.train_filename)
+        actual = self._run(lambda i: o.testFile(self.train_filename))
+        for result in actual:
+            eq_(result, desired)
+
+    def test_trainFile(self):
+        model_filenames = [tempfile.mkstemp()[1]
+                           for _ in range(self.n_threads)]
+        try:
+            ret = self._run(lambda i: _oll.trainFile(
+                self.train_filename, model_filenames[i], _oll.PA1,
+                1.0, 0.0, 5, False, False))
+            eq_(ret, [0] * self.n_threads)
+            models = []
+            for filename in model_filenames:
+                with open(filename, 'rb') as fd:
+                    models.append(fd.read())
+            eq_(len(set(models)), 1)
+            ok_(models[0])
+        finally:
+            for filename in model_filenames:
+                os.remove(filename)
+
+    def test_fit_async(self):
+        data = oll.Dataset(self.train_filename)
+        desired = oll.oll('PA1').fit(data).dumps()
+        for X in (self.train_filename, data):
+            o = oll.oll('PA1')
+            future = o.fit_async(X)
+            ok_(future.result(timeout=60) is o)
+            ok_(future.done())
+            ok_(not future.cancelled())
+            eq_(future.progress(), 1.0)
+            eq_(future.exception(), None)
+            eq_(o.dumps(), desired)
+        X = np.array([[1.0, 2.0], [0.0, -1.0]])
+        future = oll.oll('CW').fit_async(X, [1, -1], iter=3)
+        np.testing.assert_array_equal(
+            future.result().coef_, oll.oll('CW').partial_fit(
+                X, [1, -1]).partial_fit(X, [1, -1]).partial_fit(
+                    X, [1, -1]).coef_)
+
+        # the caller keeps running Python code during a long run
+        o = oll.oll('PA1')
+        future = o.fit_async(data, iter=10 ** 6)
+        ticks = 0
+        while future.progress() == 0.0 or ticks < 3:
+            ticks += 1
+        assert_raises(RuntimeError, o.add, {0: 1.0}, 1)
+        assert_raises(TimeoutError, future.result, 0.001)
+        ok_(future.cancel())
+        assert_raises(CancelledError, future.result)
+        ok_(future.cancelled())
+        ok_(0.0 < future.progress() < 1.0)
+        ok_(not future.cancel())
+        o.add({0: 1.0}, 1)
+
+        future = oll.oll('P').fit_async(self.train_filename + '.missing')
+        assert_raises(RuntimeError, future.result)
+
+    def _accuracy(self, o):
+        return np.mean([(o.classify(x) > 0) == (y > 0)
+                        for (x, y) in self.examples])
+
+    def test_fit_async_hogwild(self):
+        for algorithm in ('P', 'PA1', 'CW', 'AP', 'PAK'):
+            serial = oll.oll(algorithm)
+            serial.fit_async(self.train_filename, iter=5).result(timeout=60)
+            o = oll.oll(algorithm)
+            o.fit_async(self.train_filename, iter=5, n_jobs=4).result(
+                timeout=60)
+            eq_(_oll.oll_getExampleN(o), _oll.oll_getExampleN(serial))
+            if algorithm in ('AP', 'PAK'):  # trained serially
+                eq_(o.dumps(), serial.dumps())
+            else:
+                ok_(self._accuracy(o) > self._accuracy(serial) - 0.05)
+
+        o = oll.oll('PA1')
+        future = o.fit_async(self.train_filename, iter=10 ** 6, n_jobs=4)
+        while future.progress() == 0.0:
+            pass
+        ok_(future.cancel())
+        assert_raises(CancelledError, future.result)
+        ok_(0 < _oll.oll_getExampleN(o) < 10 ** 6 * len(self.examples))
+
+    def test_fit_async_mix(self):
+        for algorithm in ('P', 'AP', 'PA1', 'CW', 'AL', 'PAK'):
+            serial = oll.oll(algorithm)
+            serial.fit_async(self.train_filename, iter=5).result(timeout=60)
+            models = []
+            for _ in range(2):
+                o = oll.oll(algorithm)
+                o.fit_async(self.train_filename, iter=5, n_jobs=4,
+                            parallel=oll.MIX).result(timeout=60)
+                eq_(_oll.oll_getExampleN(o), _oll.oll_getExampleN(serial))
+                models.append(o)
+            eq_(models[0].dumps(), models[1].dumps())  # reproducible
+            if algorithm == 'PAK':  # trained serially
+                eq_(o.dumps(), serial.dumps())
+            else:
+                ok_(self._accuracy(o) > self._accuracy(serial) - 0.05)
+
+        o = oll.oll('PA1')
+        future = o.fit_async(self.train_filename, iter=10 ** 6, n_jobs=4,
+                             parallel=oll.MIX)
+        while future.progress() == 0.0:
+            pass
+        ok_(future.cancel())
+        assert_raises(CancelledError, future.result)
+        ok_(0 < _oll.oll_getExampleN(o) < 10 ** 6 * len(self.examples))
+
+    def test_idle_while_fit_async(self):
+        data = oll.Dataset(self.train_filename)
+        filename = tempfile.mkstemp()[1]
+        try:
+            for algorithm in ('PA1', 'AP'):
+                o = oll.oll(algorithm)
+                future = o.fit_async(data, iter=10 ** 6)
+                assert_raises(RuntimeError, lambda: o.coef_)
+                assert_raises(RuntimeError, lambda: o.intercept_)
+                assert_raises(RuntimeError, o.save, filename)
+                assert_raises(RuntimeError, o.dumps)
+                assert_raises(RuntimeError, o.classify, {0: 1.0})
+                assert_raises(RuntimeError, o.decision_function, data)
+                assert_raises(RuntimeError, o.setC, 2.0)
+                assert_raises(RuntimeError, o.setBias, 2.0)
+                eq_(o.get_params(), {'C': 1.0, 'bias': 0.0})
+                ok_(future.cancel())
+                assert_raises(CancelledError, future.result)
+                eq_(o.coef_.shape[0], 1)
+                eq_(o.save(filename), 0)
+        finally:
+            os.remove(filename)
+
+    def test_save_async(self):
+        rng = np.random.RandomState(0)
+        X = csr_matrix(rng.randn(300, 40000) * (rng.rand(300, 40000) > 0.99))
+        y = np.where(rng.rand(300) > 0.5, 1, -1)
+        tmpdir = tempfile.mkdtemp()
+        path = os.path.join(tmpdir, 'async.model')
+        try:
+            for algorithm in ('AP', 'PAK', 'CW'):
+                o = oll.oll(algorithm).fit(X[:200], y[:200])
+                desired = o.dumps()
+                future = o.save_async(path)
+                o.partial_fit(X[200:], y[200:])  # not in the file
+                ok_(future.result(timeout=60) is o)
+                eq_(future.progress(), 1.0)
+                ok_(not os.path.exists(path + '.tmp'))
+                loaded = oll.oll(algorithm)
+                eq_(loaded.load(path), 0)
+                eq_(loaded.dumps(), desired)
+
+            future = o.save_async(os.path.join(tmpdir, 'missing', 'x'))
+            assert_raises(RuntimeError, future.result)
+            ok_('Unable to open' in str(future.exception()))
+
+            # a save goes on when its future is dropped
+            desired = o.dumps()
+            o.save_async(os.path.join(tmpdir, 'dropped.model'))
+            del o
+            for i in range(600):
+                if os.path.exists(os.path.join(tmpdir, 'dropped.model')):
+                    break
+                time.sleep(0.1)
+            loaded = oll.oll('CW')
+            eq_(loaded.load(os.path.join(tmpdir, 'dropped.model')), 0)
+            eq_(loaded.dumps(), desired)
+        finally:
+            shutil.rmtree(tmpdir)
@@ -0,0 +1,103 @@
+/* Test of the C interface of lib/oll_c.h, run by test_oll.py
+ *
+ * g++ -O2 -shared -fPIC -Ilib lib/oll_c.cpp lib/oll.cpp -o liboll.so -pthread
+ * cc -std=c99 -pedantic-errors -Ilib test_oll_c.c -o test_oll_c -L. -loll
+ * LD_LIBRARY_PATH=. ./test_oll_c
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "oll_c.h"
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      fprintf(stderr, "%s:%d: %s (oll_error: %s)\n", __FILE__, __LINE__, #cond, oll_error()); \
+      failures++; \
+    } \
+  } while (0)
+
+int main(void){
+  const int   pos_ids[] = {0, 1};
+  const float pos_values[] = {1.f, 1.f};
+  const int   neg_ids[] = {2, 3};
+  const float neg_values[] = {1.f, 1.f};
+  const int   bad_ids[] = {0, -1};
+  /* the two examples above as CSR rows */
+  const int   indptr[] = {0, 2, 4};
+  const int   indices[] = {0, 1, 2, 3};
+  const float data[] = {1.f, 1.f, 1.f, 1.f};
+  const int   ys[] = {1, -1};
+  const int   bad_indptr[] = {0, 3, 2};
+  oll_model* m;
+  oll_model* loaded;
+  float scores[2];
+  char* buf;
+  size_t size;
+  char first[256];
+  int i;
+
+  CHECK(oll_create(-1, 1.f, 0.f) == NULL);
+  CHECK(strcmp(oll_error(), "unknown method") == 0);
+
+  m = oll_create(OLL_PA1, 1.f, 0.f);
+  CHECK(m != NULL);
+  if (m == NULL) return 1;
+  for (i = 0; i < 5; i++){
+    CHECK(oll_train(m, pos_ids, pos_values, 2, 1) == 0);
+    CHECK(oll_train(m, neg_ids, neg_values, 2, -1) == 0);
+  }
+  CHECK(oll_classify(m, pos_ids, pos_values, 2) > 0.f);
+  CHECK(oll_classify(m, neg_ids, neg_values, 2) < 0.f);
+  CHECK(oll_train_csr(m, indptr, indices, data, 2, ys, 3) == 0);
+  CHECK(oll_classify_csr(m, indptr, indices, data, 2, scores, 2) == 0);
+  CHECK(scores[0] == oll_classify(m, pos_ids, pos_values, 2));
+  CHECK(scores[1] == oll_classify(m, neg_ids, neg_values, 2));
+
+  /* bad input is refused before the model is touched */
+  CHECK(oll_train(m, pos_ids, pos_values, 2, 0) == -1);
+  CHECK(strcmp(oll_error(), "y is not +1 nor -1") == 0);
+  CHECK(oll_train(m, bad_ids, pos_values, 2, 1) == -1);
+  CHECK(strcmp(oll_error(), "negative feature id") == 0);
+  CHECK(oll_train_csr(m, bad_indptr, indices, data, 2, ys, 1) == -1);
+  CHECK(strcmp(oll_error(), "malformed CSR arrays") == 0);
+  CHECK(oll_classify_csr(m, bad_indptr, indices, data, 2, scores, 1) == -1);
+
+  size = oll_save_size(m);
+  CHECK(size > 0);
+  buf = malloc(size);
+  CHECK(buf != NULL);
+  if (buf == NULL) return 1;
+  CHECK(oll_save(m, buf, size) == 0);
+
+  /* each failure reports its own message only */
+  CHECK(oll_save(m, buf, size - 1) == -1);
+  CHECK(strlen(oll_error()) > 0);
+  strncpy(first, oll_error(), sizeof(first) - 1);
+  first[sizeof(first) - 1] = '\0';
+  CHECK(oll_save(m, buf, size - 1) == -1);
+  CHECK(strcmp(oll_error(), first) == 0);
+
+  loaded = oll_create(OLL_PA1, 1.f, 0.f);
+  CHECK(loaded != NULL);
+  if (loaded == NULL) return 1;
+  CHECK(oll_load(loaded, buf, size) == 0);
+  CHECK(oll_classify(loaded, pos_ids, pos_values, 2) == oll_classify(m, pos_ids, pos_values, 2));
+  CHECK(oll_classify(loaded, neg_ids, neg_values, 2) == oll_classify(m, neg_ids, neg_values, 2));
+
+  CHECK(oll_load(loaded, buf, size / 2) == -1);
+  CHECK(strlen(oll_error()) > 0);
+  buf[40] ^= 0x40; /* exampleN in the header */
+  CHECK(oll_load(loaded, buf, size) == -1);
+  CHECK(strlen(oll_error()) > 0);
+  CHECK(oll_classify(loaded, pos_ids, pos_values, 2) == oll_classify(m, pos_ids, pos_values, 2));
+
+  free(buf);
+  oll_free(loaded);
+  oll_free(m);
+  oll_free(NULL);
+  if (failures == 0) printf("ok\n");
+  return failures == 0 ? 0 : 1;
+}